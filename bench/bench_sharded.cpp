@@ -0,0 +1,103 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Sharded notification scaling benchmark
+//
+//	Every thread subscribes, emits and unsubscribes in a loop, for 1 to 64 threads
+//	Compares ShardedNotification with a single mutex guarded vector of delegates
+//	Build: g++ -std=c++17 -O2 -pthread bench_sharded.cpp (or cl /std:c++17 /O2 /EHsc bench_sharded.cpp)
+//	Scaling shows only with at least as many hardware threads as the benchmark threads
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//
+//	Includes
+//
+#include "../src/ncd_sharded.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace ncd;
+using Clock = std::chrono::steady_clock;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct SFeed
+{
+};
+
+static void OnQuote(int)
+{
+}
+
+using FeedNotification = ShardedNotification<SFeed, int>;
+using FeedDelegate = FeedNotification::DelegateType;
+
+static std::chrono::milliseconds const c_tRunTime(300);
+static int const c_nBatch = 100;
+
+// Runs fnOperation on nThreads threads for the run time, returns operations per second
+template <typename TOperation>
+static double Measure(int nThreads, TOperation fnOperation)
+{
+	std::atomic<long long> nTotal {0};
+	std::vector<std::thread> aThreads;
+	Clock::time_point const tStart = Clock::now();
+	for (int i = 0; i < nThreads; ++i)
+	{
+		aThreads.emplace_back([&]() {
+			long long nOps = 0;
+			Clock::time_point const tEnd = Clock::now() + c_tRunTime;
+			while (Clock::now() < tEnd)
+			{
+				for (int j = 0; j < c_nBatch; ++j)
+					fnOperation();
+				nOps += c_nBatch;
+			}
+			nTotal += nOps;
+		});
+	}
+	for (std::thread& oThread : aThreads)
+		oThread.join();
+	return nTotal.load() / std::chrono::duration<double>(Clock::now() - tStart).count();
+}
+
+int main()
+{
+	std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+	std::printf("threads   sharded (Mops/s)   mutex+vector (Mops/s)\n");
+	for (int nThreads = 1; nThreads <= 64; nThreads *= 2)
+	{
+		FeedNotification oSharded;
+		double const dSharded = Measure(nThreads, [&oSharded]() {
+			FeedNotification::SToken const oToken = oSharded.SubscribeToken(FeedDelegate::Create<&OnQuote>());
+			oSharded.Notify(nullptr, 1);
+			oSharded.Unsubscribe(oToken);
+		});
+
+		std::mutex oLock;
+		std::vector<FeedDelegate> aDelegates;
+		double const dLocked = Measure(nThreads, [&oLock, &aDelegates]() {
+			std::lock_guard<std::mutex> oGuard(oLock);
+			aDelegates.push_back(FeedDelegate::Create<&OnQuote>());
+			for (FeedDelegate const& oDelegate : aDelegates)
+				oDelegate(static_cast<SFeed*>(nullptr), 1);
+			aDelegates.pop_back();
+		});
+
+		std::printf("%7d   %16.2f   %21.2f\n", nThreads, dSharded / 1e6, dLocked / 1e6);
+	}
+	return 0;
+}
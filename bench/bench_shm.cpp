@@ -0,0 +1,202 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Cross-process notification benchmark (Linux)
+//
+//	Latency: parent emits ping carrying its timestamp, child re-emits it straight into the pong publisher,
+//	one-way latency is half of the round trip
+//	Throughput: child streams emissions as fast as the ring accepts them (blocking publisher), parent pumps all available ones
+//	Build: g++ -std=c++17 -O2 -pthread bench_shm.cpp (-lrt on old glibc)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//
+//	Includes
+//
+#include "../src/ncd_shm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <sys/wait.h>
+
+using namespace ncd;
+using Clock = std::chrono::steady_clock;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct SBench
+{
+	Notification<SBench, int64_t>			Ping;
+	Notification<SBench, int64_t>			Pong;
+	Notification<SBench, int64_t, int64_t>	Data;
+};
+
+static char const* const c_szPing = "/ncd_bench_ping";
+static char const* const c_szPong = "/ncd_bench_pong";
+static char const* const c_szData = "/ncd_bench_data";
+static int const c_nRoundTrips = 100000;
+static int64_t const c_nMessages = 5000000;
+static std::chrono::seconds const c_tTimeout(5);
+
+static int64_t Now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+// Child side of the latency run: every ping is published back as pong
+static int RunEcho(int nReadyPipe)
+{
+	SBench oBench;
+	TShmPublisher<int64_t> cntPong;
+	if (!cntPong.Create(c_szPong, 64))
+		return 1;
+	cntPong.Connect(oBench.Ping);
+
+	TShmReceiver<SBench, int64_t> oPingReceiver(oBench.Ping, &oBench);
+	if (!oPingReceiver.Open(c_szPing))
+		return 1;
+	char chReady = 1;
+	if (::write(nReadyPipe, &chReady, 1) != 1)
+		return 1;
+
+	while (oPingReceiver.Pump(0, c_tTimeout) == EShmStatus::Ok)
+		;
+	return 0;
+}
+
+// Child side of the throughput run: segment is created before the parent opens it, streaming starts
+// once the parent is attached
+static int RunStream(int nCreatedPipe, int nStartPipe)
+{
+	SBench oBench;
+	TShmPublisher<int64_t, int64_t> cntData;
+	if (!cntData.Create(c_szData, 4096))
+		return 1;
+	cntData.SetFullPolicy(EShmFullPolicy::Block);
+	cntData.Connect(oBench.Data);
+	char chSignal = 1;
+	if (::write(nCreatedPipe, &chSignal, 1) != 1 || ::read(nStartPipe, &chSignal, 1) != 1)
+		return 1;
+
+	for (int64_t i = 0; i < c_nMessages; ++i)
+		oBench.Data.Notify(&oBench, i, i);
+	return (cntData.GetDroppedCount() == 0) ? 0 : 1;
+}
+
+static void MeasureLatency()
+{
+	SBench oBench;
+	TShmPublisher<int64_t> cntPing;
+	if (!cntPing.Create(c_szPing, 64))
+		return;
+	cntPing.Connect(oBench.Ping);
+
+	int aPipe[2];
+	if (::pipe(aPipe) != 0)
+		return;
+	pid_t const nChild = ::fork();
+	if (nChild == 0)
+		::_exit(RunEcho(aPipe[1]));
+
+	char chReady = 0;
+	TShmReceiver<SBench, int64_t> oPongReceiver(oBench.Pong, &oBench);
+	if (::read(aPipe[0], &chReady, 1) == 1 && oPongReceiver.Open(c_szPong))
+	{
+		std::vector<int64_t> aLatencies;
+		aLatencies.reserve(c_nRoundTrips);
+		bool bReceived = false;
+		auto fnOnPong = [&](int64_t nSent)
+		{
+			aLatencies.push_back((Now() - nSent) / 2);
+			bReceived = true;
+		};
+		TConnection<int64_t> cntOnPong(oBench.Pong, TConnection<int64_t>::DelegateType::Create(fnOnPong));
+
+		EShmStatus eStatus = EShmStatus::Ok;
+		for (int i = 0; i < c_nRoundTrips && eStatus == EShmStatus::Ok; ++i)
+		{
+			bReceived = false;
+			oBench.Ping.Notify(&oBench, Now());
+			while (!bReceived && eStatus == EShmStatus::Ok)
+				eStatus = oPongReceiver.Pump(0, c_tTimeout);
+		}
+
+		std::sort(aLatencies.begin(), aLatencies.end());
+		if (!aLatencies.empty())
+		{
+			std::printf("one-way latency over %zu round trips: p50 %lld ns, p99 %lld ns, max %lld ns\n", aLatencies.size(),
+						static_cast<long long>(aLatencies[aLatencies.size() / 2]),
+						static_cast<long long>(aLatencies[aLatencies.size() * 99 / 100]),
+						static_cast<long long>(aLatencies.back()));
+		}
+	}
+
+	cntPing.Close();
+	::waitpid(nChild, nullptr, 0);
+	::shm_unlink(c_szPing);
+	::shm_unlink(c_szPong);
+	::close(aPipe[0]);
+	::close(aPipe[1]);
+}
+
+static void MeasureThroughput()
+{
+	int aPipe[2];
+	if (::pipe(aPipe) != 0)
+		return;
+	int aCreated[2];
+	if (::pipe(aCreated) != 0)
+		return;
+	pid_t const nChild = ::fork();
+	if (nChild == 0)
+		::_exit(RunStream(aCreated[1], aPipe[0]));
+
+	SBench oBench;
+	int64_t nReceived = 0;
+	bool bOrdered = true;
+	auto fnOnData = [&](int64_t nSeq, int64_t)
+	{
+		bOrdered = bOrdered && (nSeq == nReceived);
+		++nReceived;
+	};
+	TConnection<int64_t, int64_t> cntOnData(oBench.Data, TConnection<int64_t, int64_t>::DelegateType::Create(fnOnData));
+	TShmReceiver<SBench, int64_t, int64_t> oDataReceiver(oBench.Data, &oBench);
+
+	char chCreated = 0;
+	if (::read(aCreated[0], &chCreated, 1) == 1 && oDataReceiver.Open(c_szData))
+	{
+		char chReady = 1;
+		Clock::time_point const tStart = Clock::now();
+		if (::write(aPipe[1], &chReady, 1) == 1)
+		{
+			while (nReceived < c_nMessages && oDataReceiver.Pump(0, c_tTimeout) == EShmStatus::Ok)
+				;
+		}
+		double const dSeconds = std::chrono::duration<double>(Clock::now() - tStart).count();
+		std::printf("throughput: %lld emissions in %.3f s, %.2f M/s%s\n", static_cast<long long>(nReceived), dSeconds,
+					nReceived / dSeconds / 1e6, bOrdered ? "" : " (out of order!)");
+	}
+
+	::waitpid(nChild, nullptr, 0);
+	::shm_unlink(c_szData);
+	for (int nFd : {aPipe[0], aPipe[1], aCreated[0], aCreated[1]})
+		::close(nFd);
+}
+
+int main()
+{
+	MeasureLatency();
+	MeasureThroughput();
+	return 0;
+}
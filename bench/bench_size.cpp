@@ -0,0 +1,96 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Code size benchmark
+//
+//	Instantiates notifications and connections of 300 distinct signatures, every signature connects, blocks,
+//	mutes, notifies and disconnects, so the binary grows with the code instantiated per signature
+//	Nothing is printed, compare the text size of the binary built from different revisions
+//	Build: g++ -std=c++17 -O2 bench_size.cpp && size a.out (or cl /std:c++17 /O2 /EHsc and dumpbin /headers)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//
+//	Includes
+//
+#include "../src/ncd_core.h"
+
+#include <cstddef>
+#include <utility>
+
+#if defined(_MSC_VER)
+#define NCD_BENCH_NOINLINE __declspec(noinline)
+#else
+#define NCD_BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+using namespace ncd;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static size_t const c_nSignatures = 300;
+
+struct SSender
+{
+};
+
+// Distinct argument type per signature
+template <size_t nId>
+struct STag
+{
+	int nValue;
+};
+
+static int g_nSum = 0;
+
+template <size_t nId>
+struct SReceiver
+{
+	static void OnTag(STag<nId> oTag)
+	{
+		g_nSum += oTag.nValue;
+	}
+};
+
+template <size_t nId>
+NCD_BENCH_NOINLINE void UseSignature()
+{
+	using ConnectionType = TConnection<STag<nId>>;
+	Notification<SSender, STag<nId>> oNtfctn;
+	ConnectionType oCnctn(ConnectionType::DelegateType::template Create<&SReceiver<nId>::OnTag>());
+
+	oCnctn.Connect(oNtfctn);
+	oNtfctn.AddConnection(oCnctn);
+	{
+		auto oBlock = oNtfctn.Block();
+	}
+	{
+		auto oMute = oCnctn.Mute();
+	}
+	oNtfctn.Notify(nullptr, STag<nId>{static_cast<int>(nId)});
+	oNtfctn.RemoveConnection(oCnctn);
+	oCnctn.Connect(oNtfctn);
+	oCnctn.Disconnect(oNtfctn);
+	oNtfctn += oCnctn;
+	oCnctn.DisconnectAll();
+}
+
+template <size_t... nIds>
+void UseSignatures(std::index_sequence<nIds...>)
+{
+	int aCalls[] = {(UseSignature<nIds>(), 0)...};
+	(void) aCalls;
+}
+
+int main()
+{
+	UseSignatures(std::make_index_sequence<c_nSignatures>());
+	return (g_nSum > 0) ? 0 : 1;
+}
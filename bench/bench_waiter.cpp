@@ -0,0 +1,181 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Waiter wakeup latency benchmark
+//
+//	Wakeup: producer emits its timestamp to the sleeping consumer, consumer measures the time until it runs with
+//	the value, prints p50/p99 of the wakeup latency. Producer pauses before every emission, so the consumer is
+//	really asleep when the emission arrives. Wakeup latency is dominated by the context switch, Waiter is not
+//	expected to wake up faster than the condition variable
+//	Emission: producer emits while the consumer is busy (not asleep), prints the cost of the emission,
+//	here Waiter takes no lock and makes no system call
+//	Both compare Waiter with the mutex and condition variable handoff
+//	Build: g++ -std=c++17 -O2 -pthread bench_waiter.cpp (or cl /std:c++17 /O2 /EHsc bench_waiter.cpp)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//
+//	Includes
+//
+#include "../src/ncd_waiter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace ncd;
+using Clock = std::chrono::steady_clock;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct SProducer
+{
+	Notification<SProducer, int64_t>	Ping;
+};
+
+static int const c_nWakeups = 20000;
+static int const c_nEmissions = 10000000;
+static std::chrono::microseconds const c_tPause(20);
+
+static int64_t Now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+static void Report(char const* szName, std::vector<int64_t>& aLatencies)
+{
+	std::sort(aLatencies.begin(), aLatencies.end());
+	std::printf("%-20s p50 %7lld ns   p99 %7lld ns\n", szName,
+				static_cast<long long>(aLatencies[aLatencies.size() / 2]),
+				static_cast<long long>(aLatencies[aLatencies.size() * 99 / 100]));
+}
+
+// Runs producer on the calling thread, fnEmit(nTimestamp) hands the timestamp over to the consumer
+template <typename TEmit>
+static void RunProducer(std::atomic<int>& nConsumed, TEmit fnEmit)
+{
+	for (int i = 0; i < c_nWakeups; ++i)
+	{
+		std::this_thread::sleep_for(c_tPause);
+		fnEmit(Now());
+		while (nConsumed.load() != i + 1)
+			std::this_thread::yield();
+	}
+}
+
+static void MeasureWaiter()
+{
+	SProducer oProducer;
+	Waiter oWaiter;
+	auto& oPing = oWaiter.Attach(oProducer.Ping);
+	std::vector<int64_t> aLatencies;
+	aLatencies.reserve(c_nWakeups);
+	std::atomic<int> nConsumed {0};
+
+	std::thread oConsumer([&]() {
+		for (int i = 0; i < c_nWakeups; ++i)
+		{
+			oWaiter.Wait();
+			int64_t nSent = std::get<0>(oPing.Take());
+			aLatencies.push_back(Now() - nSent);
+			nConsumed.store(i + 1);
+		}
+	});
+	RunProducer(nConsumed, [&oProducer](int64_t nTimestamp) {
+		oProducer.Ping.Notify(&oProducer, nTimestamp);
+	});
+	oConsumer.join();
+	Report("Waiter", aLatencies);
+}
+
+static void MeasureConditionVariable()
+{
+	std::mutex oLock;
+	std::condition_variable oCondition;
+	int64_t nValue = 0;
+	bool bPending = false;
+	std::vector<int64_t> aLatencies;
+	aLatencies.reserve(c_nWakeups);
+	std::atomic<int> nConsumed {0};
+
+	std::thread oConsumer([&]() {
+		for (int i = 0; i < c_nWakeups; ++i)
+		{
+			std::unique_lock<std::mutex> oGuard(oLock);
+			oCondition.wait(oGuard, [&bPending]() {return bPending;});
+			bPending = false;
+			aLatencies.push_back(Now() - nValue);
+			oGuard.unlock();
+			nConsumed.store(i + 1);
+		}
+	});
+	RunProducer(nConsumed, [&](int64_t nTimestamp) {
+		{
+			std::lock_guard<std::mutex> oGuard(oLock);
+			nValue = nTimestamp;
+			bPending = true;
+		}
+		oCondition.notify_one();
+	});
+	oConsumer.join();
+	Report("condition_variable", aLatencies);
+}
+
+// Emits to the consumer which is busy, so nobody sleeps on the emission and the pending value is overwritten
+static void MeasureEmission(char const* szName, SProducer& oProducer)
+{
+	Clock::time_point const tStart = Clock::now();
+	for (int i = 0; i < c_nEmissions; ++i)
+		oProducer.Ping.Notify(&oProducer, i);
+	double const dNs = std::chrono::duration<double, std::nano>(Clock::now() - tStart).count() / c_nEmissions;
+	std::printf("%-20s emission %6.1f ns\n", szName, dNs);
+}
+
+static void MeasureEmissions()
+{
+	{
+		SProducer oProducer;
+		Waiter oWaiter;
+		oWaiter.Attach(oProducer.Ping);
+		MeasureEmission("Waiter", oProducer);
+	}
+
+	// Condition variable handoff made by the listener of the same notification
+	SProducer oProducer;
+	std::mutex oLock;
+	std::condition_variable oCondition;
+	int64_t nValue = 0;
+	bool bPending = false;
+	auto fnHandoff = [&](int64_t nNewValue)
+	{
+		{
+			std::lock_guard<std::mutex> oGuard(oLock);
+			nValue = nNewValue;
+			bPending = true;
+		}
+		oCondition.notify_one();
+	};
+	TConnection<int64_t> cntHandoff(oProducer.Ping, TConnection<int64_t>::DelegateType::Create(fnHandoff));
+	MeasureEmission("condition_variable", oProducer);
+}
+
+int main()
+{
+	MeasureWaiter();
+	MeasureConditionVariable();
+	MeasureEmissions();
+	return 0;
+}
@@ -0,0 +1,270 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Class-wide notification (observing all instances of the sender class)
+//
+//	Static notification of the class, any instance emits it with itself as the sender,
+//	so a single connection observes all instances instead of one link per instance
+//	Subscribers interested in the particular instance connect through the per-sender filter:
+//	filtered connections live in the separate notification of that sender, found by one hash lookup,
+//	so they are not invoked (and do not cost anything) for the emissions of other instances
+//	Sender should call ForgetSender upon destruction to drop its filter (filtered connections get disconnected)
+//
+//	Usage example
+//
+/*
+	class CSession
+	{
+	public:
+		static inline ClassNotification<CSession, int>	Closed;
+
+		~CSession()
+		{
+			Closed.Notify(this, m_nReason);
+			Closed.ForgetSender(this);
+		}
+	};
+
+	CSession::Closed.Connect(cnt_onAnySessionClosed);				// all sessions
+	CSession::Closed.Connect(cnt_onMySessionClosed, &oSession);	// only oSession
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_CLASSWIDE_H
+#define NCD_CLASSWIDE_H
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+
+#include <unordered_map>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TClassNotification
+//	Class-wide notification with the indexed per-sender filter
+//
+template <class TSender, typename... TArguments>
+class TClassNotification
+{
+public:
+	//	Type definitions
+	using NotificationType = TNotificationX<TSender, TArguments...>;
+	using FilteredNotificationType = TNotification<TArguments...>;
+	using ConnectionType = TConnection<TArguments...>;
+
+	inline TClassNotification() = default;
+	inline ~TClassNotification() = default;
+
+	TClassNotification(TClassNotification const&) = delete;
+	void operator=(TClassNotification const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Emits to the class-wide connections and then to the connections filtered by this sender
+	inline void Notify(TSender* pSender, TArguments... args) const;
+	inline void operator() (TSender* pSender, TArguments... args) const;
+
+	// Connects to the emissions of all instances
+	inline void Connect(ConnectionType const& oCnctn) const;
+	// Connects to the emissions of the specified instance only
+	inline void Connect(ConnectionType const& oCnctn, TSender const* pSender) const;
+	// Disconnects class-wide connection
+	inline bool Disconnect(ConnectionType const& oCnctn) const;
+	// Disconnects connection filtered by the specified instance
+	inline bool Disconnect(ConnectionType const& oCnctn, TSender const* pSender) const;
+
+	// Drops the filter of the instance, its connections get disconnected
+	// Filter of the instance which is emitting right now is dropped when the emission ends
+	inline void ForgetSender(TSender const* pSender);
+	// Drops filters left without connections
+	inline void Shrink();
+
+	// Returns class-wide notification (could be chained, blocked, introspected)
+	inline NotificationType& GetNotification();
+	inline NotificationType const& GetNotification() const;
+	// Returns filtered notification of the instance or nullptr if there is no filter
+	inline FilteredNotificationType const* GetFiltered(TSender const* pSender) const;
+	// Returns number of instances having the filter
+	inline size_t GetFilteredSenderCount() const;
+
+private:
+	//
+	//	Implementation
+	//
+	// Returns filter of the instance, creates it upon the first filtered connection
+	inline FilteredNotificationType const& AcquireFiltered(TSender const* pSender) const;
+	// Erases filters left without connections (not while emitting)
+	inline void EraseEmptyFilters() const;
+
+private:
+	//
+	//	Contents
+	//
+	NotificationType m_oAll;
+	// Filters are the bookkeeping of the filtered connections, as the connection lists are for the notifications,
+	// so they are created and erased by the const methods
+	// Node based map keeps filtered notifications in place, so rehashing does not break their links
+	mutable std::unordered_map<TSender const*, FilteredNotificationType> m_mapFiltered;
+	// Nesting level of the filtered emissions and the erasure of the empty filters postponed until they end
+	mutable uint32_t m_nEmitDepth = 0;
+	mutable bool m_bForgetPending = false;
+};
+
+//
+//	Final class-wide notification definition for the external use
+//
+template <class TSender, typename... TArguments>
+using ClassNotification = TClassNotification<TSender, TArguments...>;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TClassNotification Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <class TSender, typename... TArguments>
+inline void TClassNotification<TSender, TArguments...>::Notify(TSender* pSender, TArguments... args) const
+{
+	m_oAll.Notify(pSender, args...);
+	if (m_mapFiltered.empty())
+		return;
+
+	auto it = m_mapFiltered.find(pSender);
+	if (it == m_mapFiltered.end())
+		return;
+
+	++m_nEmitDepth;
+	it->second.Notify(pSender, args...);
+	if (--m_nEmitDepth == 0 && m_bForgetPending)
+		EraseEmptyFilters();
+}
+
+template <class TSender, typename... TArguments>
+inline void TClassNotification<TSender, TArguments...>::operator() (TSender* pSender, TArguments... args) const
+{
+	Notify(pSender, args...);
+}
+
+template <class TSender, typename... TArguments>
+inline void TClassNotification<TSender, TArguments...>::Connect(ConnectionType const& oCnctn) const
+{
+	m_oAll.AddConnection(oCnctn);
+}
+
+template <class TSender, typename... TArguments>
+inline void TClassNotification<TSender, TArguments...>::Connect(ConnectionType const& oCnctn, TSender const* pSender) const
+{
+	AcquireFiltered(pSender).AddConnection(oCnctn);
+}
+
+template <class TSender, typename... TArguments>
+inline bool TClassNotification<TSender, TArguments...>::Disconnect(ConnectionType const& oCnctn) const
+{
+	return m_oAll.RemoveConnection(oCnctn);
+}
+
+template <class TSender, typename... TArguments>
+inline bool TClassNotification<TSender, TArguments...>::Disconnect(ConnectionType const& oCnctn, TSender const* pSender) const
+{
+	auto it = m_mapFiltered.find(pSender);
+	return (it != m_mapFiltered.end() && it->second.RemoveConnection(oCnctn));
+}
+
+template <class TSender, typename... TArguments>
+inline void TClassNotification<TSender, TArguments...>::ForgetSender(TSender const* pSender)
+{
+	auto it = m_mapFiltered.find(pSender);
+	if (it == m_mapFiltered.end())
+		return;
+
+	if (m_nEmitDepth > 0)
+	{
+		// Filtered notification could be emitting, disconnect now and erase it later
+		it->second.RemoveAllConnections();
+		m_bForgetPending = true;
+		return;
+	}
+	m_mapFiltered.erase(it);
+}
+
+template <class TSender, typename... TArguments>
+inline void TClassNotification<TSender, TArguments...>::Shrink()
+{
+	if (m_nEmitDepth > 0)
+		m_bForgetPending = true;
+	else
+		EraseEmptyFilters();
+}
+
+template <class TSender, typename... TArguments>
+inline typename TClassNotification<TSender, TArguments...>::NotificationType&
+TClassNotification<TSender, TArguments...>::GetNotification()
+{
+	return m_oAll;
+}
+
+template <class TSender, typename... TArguments>
+inline typename TClassNotification<TSender, TArguments...>::NotificationType const&
+TClassNotification<TSender, TArguments...>::GetNotification() const
+{
+	return m_oAll;
+}
+
+template <class TSender, typename... TArguments>
+inline typename TClassNotification<TSender, TArguments...>::FilteredNotificationType const*
+TClassNotification<TSender, TArguments...>::GetFiltered(TSender const* pSender) const
+{
+	auto it = m_mapFiltered.find(pSender);
+	return (it != m_mapFiltered.end()) ? &it->second : nullptr;
+}
+
+template <class TSender, typename... TArguments>
+inline size_t TClassNotification<TSender, TArguments...>::GetFilteredSenderCount() const
+{
+	return m_mapFiltered.size();
+}
+
+template <class TSender, typename... TArguments>
+inline typename TClassNotification<TSender, TArguments...>::FilteredNotificationType const&
+TClassNotification<TSender, TArguments...>::AcquireFiltered(TSender const* pSender) const
+{
+	return m_mapFiltered.try_emplace(pSender).first->second;
+}
+
+template <class TSender, typename... TArguments>
+inline void TClassNotification<TSender, TArguments...>::EraseEmptyFilters() const
+{
+	m_bForgetPending = false;
+	for (auto it = m_mapFiltered.begin(); it != m_mapFiltered.end();)
+	{
+		if (!it->second.HasConnections())
+			it = m_mapFiltered.erase(it);
+		else
+			++it;
+	}
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_CLASSWIDE_H
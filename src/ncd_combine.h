@@ -0,0 +1,515 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Notification combinators (combine latest, zip, merge)
+//
+//	Combinator connects to several notifications (of different signatures) and emits its own notification
+//	computed from the latest arguments of the inputs, instead of hand-written connection and state per input
+//	State is the fixed tuple of input values (arguments are decayed and copied, single argument is kept as is,
+//	several arguments as the tuple), combinator itself does not allocate
+//	Inputs fired within one cascade (top-level emission of the thread with all nested ones) are coalesced:
+//	result is emitted once, when the cascade ends (see CCascadeHook in ncd_core.h)
+//	Result is emitted with the combinator as the sender, its arguments refer to the combinator state
+//
+//		CombineLatest	- emits values of all inputs when any of them fired (once all inputs fired at least once)
+//		Zip				- emits values of all inputs when every input fired since the previous result,
+//						  input fired again before that overwrites its value (counted by GetOverwritten)
+//		Merge			- inputs of the same signature, emits arguments of the input fired last
+//
+//	Usage example
+//
+/*
+	CombineLatest<TNotification<double>, TNotification<std::string const&>> oQuote(oFeed.PriceChanged, oFeed.VenueChanged);
+	cnt_onQuote.Connect(oQuote.GetNotification());	// void onQuote(double const& dPrice, std::string const& sVenue)
+
+	Merge<TNotification<int>, TNotification<int>> oAnyError(oNetwork.Failed, oStorage.Failed);
+	cnt_onError.Connect(oAnyError.GetNotification());	// void onError(int const& nCode), GetLastInput() tells the source
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_COMBINE_H
+#define NCD_COMBINE_H
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TCombinatorInput
+//	Signature traits of the combinator input
+//
+template <typename... TArguments>
+struct TCombinatorInput
+{
+	using NotificationType = TNotification<TArguments...>;
+	using ConnectionType = TConnection<TArguments...>;
+	using DelegateType = typename ConnectionType::DelegateType;
+	// Single argument is stored as is, others as the tuple
+	using ValueType = std::conditional_t<sizeof...(TArguments) == 1,
+										 std::decay_t<std::tuple_element_t<0, std::tuple<TArguments..., void>>>,
+										 std::tuple<std::decay_t<TArguments>...>>;
+	// Notification emitting the stored value unpacked
+	template <class TSender>
+	using UnpackedNotificationType = TNotificationX<TSender, std::decay_t<TArguments> const&...>;
+
+	// Returns delegate invoking tOwner.OnInput<tIdx>
+	template <size_t tIdx, class TOwner>
+	static inline DelegateType MakeDelegate(TOwner& oOwner);
+	// Emits the value unpacked into the arguments
+	template <class TSender>
+	static inline void Emit(UnpackedNotificationType<TSender> const& oNtfctn, TSender* pSender, ValueType const& tValue);
+};
+
+// Input traits of the notification type (TNotification and its derivatives)
+template <typename... TArguments>
+inline TCombinatorInput<TArguments...> CombinatorInputOf(TNotification<TArguments...> const*);
+
+template <class TNtfctn>
+using CombinatorInput = decltype(CombinatorInputOf(static_cast<TNtfctn const*>(nullptr)));
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TCombinatorBase
+//	Input connections, their latest values and the coalescing of the inputs fired within one cascade
+//
+template <class... TNtfctns>
+class TCombinatorBase : private CCascadeHook
+{
+	static_assert(sizeof...(TNtfctns) > 0 && sizeof...(TNtfctns) <= 64, "Combinator takes from 1 to 64 inputs");
+
+public:
+	//	Type definitions
+	using ValuesType = std::tuple<typename CombinatorInput<TNtfctns>::ValueType...>;
+	static constexpr size_t c_nInputs = sizeof...(TNtfctns);
+
+	TCombinatorBase(TCombinatorBase const&) = delete;
+	void operator=(TCombinatorBase const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Returns latest values of all inputs (default constructed for inputs not fired yet)
+	inline ValuesType const& GetValues() const;
+	// Returns true if the input fired at least once since construction or reset
+	inline bool HasValue(size_t nInput) const;
+	// Returns index of the input fired last
+	inline size_t GetLastInput() const;
+	// Forgets which inputs fired (values are kept), pending result is dropped
+	inline void Reset();
+
+	// Disconnects from all inputs (or connects back)
+	inline void Detach();
+	inline void Attach();
+
+protected:
+	inline TCombinatorBase(typename CombinatorInput<TNtfctns>::NotificationType const&... oNtfctns);
+	inline ~TCombinatorBase() = default;
+
+	// Called at the end of the cascade in which some inputs fired
+	virtual void OnInputsFired() = 0;
+	// Called by Reset, combinators keeping own progress state forget it here
+	virtual void OnReset() {}
+
+	// Returns mask of all inputs
+	static constexpr uint64_t AllInputs() {return (c_nInputs == 64) ? ~uint64_t(0) : (uint64_t(1) << c_nInputs) - 1;}
+
+private:
+	//
+	//	Implementation
+	//
+	using InputsType = std::tuple<typename CombinatorInput<TNtfctns>::ConnectionType...>;
+	using NotificationsType = std::tuple<typename CombinatorInput<TNtfctns>::NotificationType const*...>;
+
+	template <size_t tIdx, typename... TArguments>
+	inline void OnInput(TArguments... args);
+
+	template <size_t... tIdx>
+	inline void AttachInputs(std::index_sequence<tIdx...>);
+
+	inline void OnCascadeEnd() override;
+
+	template <typename...> friend struct TCombinatorInput;
+
+protected:
+	//
+	//	Contents
+	//
+	ValuesType			m_tValues;
+	// Inputs fired at least once and inputs fired since the last result
+	uint64_t			m_nHasValue = 0;
+	uint64_t			m_nFired = 0;
+	size_t				m_nLastInput = 0;
+
+private:
+	NotificationsType	m_tNotifications;
+	InputsType			m_tInputs;
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TCombineLatest
+//	Emits latest values of all inputs whenever any of them fired
+//
+template <class... TNtfctns>
+class TCombineLatest final : public TCombinatorBase<TNtfctns...>
+{
+	using Base = TCombinatorBase<TNtfctns...>;
+
+public:
+	using ResultNotificationType = TNotificationX<TCombineLatest, typename CombinatorInput<TNtfctns>::ValueType const&...>;
+	using NotificationType = typename ResultNotificationType::NotificationType;
+
+	inline TCombineLatest(typename CombinatorInput<TNtfctns>::NotificationType const&... oNtfctns);
+
+	// Returns combined notification
+	inline NotificationType const& GetNotification() const;
+
+private:
+	inline void OnInputsFired() override;
+
+	template <size_t... tIdx>
+	inline void Emit(std::index_sequence<tIdx...>);
+
+private:
+	ResultNotificationType m_oResult;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TZip
+//	Emits values of all inputs once every input fired since the previous result
+//
+template <class... TNtfctns>
+class TZip final : public TCombinatorBase<TNtfctns...>
+{
+	using Base = TCombinatorBase<TNtfctns...>;
+
+public:
+	using ResultNotificationType = TNotificationX<TZip, typename CombinatorInput<TNtfctns>::ValueType const&...>;
+	using NotificationType = typename ResultNotificationType::NotificationType;
+
+	inline TZip(typename CombinatorInput<TNtfctns>::NotificationType const&... oNtfctns);
+
+	// Returns zipped notification
+	inline NotificationType const& GetNotification() const;
+	// Returns number of input values overwritten before they were zipped
+	inline uint64_t GetOverwritten() const;
+
+private:
+	inline void OnInputsFired() override;
+	inline void OnReset() override;
+
+	template <size_t... tIdx>
+	inline void Emit(std::index_sequence<tIdx...>);
+
+private:
+	ResultNotificationType	m_oResult;
+	uint64_t				m_nOverwritten = 0;
+	uint64_t				m_nPending = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TMerge
+//	Emits arguments of the input fired last (all inputs have the same signature)
+//
+template <class TNtfctn, class... TNtfctns>
+class TMerge final : public TCombinatorBase<TNtfctn, TNtfctns...>
+{
+	using Base = TCombinatorBase<TNtfctn, TNtfctns...>;
+	using InputType = CombinatorInput<TNtfctn>;
+	static_assert(std::conjunction<std::is_same<InputType, CombinatorInput<TNtfctns>>...>::value,
+				  "Merged notifications should have the same signature");
+
+public:
+	using ResultNotificationType = typename InputType::template UnpackedNotificationType<TMerge>;
+	using NotificationType = typename ResultNotificationType::NotificationType;
+
+	inline TMerge(typename InputType::NotificationType const& oNtfctn,
+				  typename CombinatorInput<TNtfctns>::NotificationType const&... oNtfctns);
+
+	// Returns merged notification
+	inline NotificationType const& GetNotification() const;
+
+private:
+	inline void OnInputsFired() override;
+
+	template <size_t... tIdx>
+	inline typename InputType::ValueType const& GetValue(size_t nInput, std::index_sequence<tIdx...>) const;
+
+private:
+	ResultNotificationType m_oResult;
+};
+
+//
+//	Final combinator definitions for the external use
+//
+template <class... TNtfctns>
+using CombineLatest = TCombineLatest<TNtfctns...>;
+
+template <class... TNtfctns>
+using Zip = TZip<TNtfctns...>;
+
+template <class TNtfctn, class... TNtfctns>
+using Merge = TMerge<TNtfctn, TNtfctns...>;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TCombinatorInput Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename... TArguments>
+template <size_t tIdx, class TOwner>
+inline typename TCombinatorInput<TArguments...>::DelegateType TCombinatorInput<TArguments...>::MakeDelegate(TOwner& oOwner)
+{
+	return DelegateType::template Create<TOwner, &TOwner::template OnInput<tIdx, TArguments...>>(oOwner);
+}
+
+template <typename... TArguments>
+template <class TSender>
+inline void TCombinatorInput<TArguments...>::Emit(UnpackedNotificationType<TSender> const& oNtfctn, TSender* pSender,
+												  ValueType const& tValue)
+{
+	if constexpr (sizeof...(TArguments) == 1)
+		oNtfctn.Notify(pSender, tValue);
+	else
+		std::apply([&](auto const&... args) {oNtfctn.Notify(pSender, args...);}, tValue);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TCombinatorBase Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <class... TNtfctns>
+inline TCombinatorBase<TNtfctns...>::TCombinatorBase(typename CombinatorInput<TNtfctns>::NotificationType const&... oNtfctns) :
+	m_tValues(), m_tNotifications(&oNtfctns...)
+{
+	AttachInputs(std::index_sequence_for<TNtfctns...>());
+}
+
+template <class... TNtfctns>
+inline typename TCombinatorBase<TNtfctns...>::ValuesType const& TCombinatorBase<TNtfctns...>::GetValues() const
+{
+	return m_tValues;
+}
+
+template <class... TNtfctns>
+inline bool TCombinatorBase<TNtfctns...>::HasValue(size_t nInput) const
+{
+	return (nInput < c_nInputs && (m_nHasValue & (uint64_t(1) << nInput)) != 0);
+}
+
+template <class... TNtfctns>
+inline size_t TCombinatorBase<TNtfctns...>::GetLastInput() const
+{
+	return m_nLastInput;
+}
+
+template <class... TNtfctns>
+inline void TCombinatorBase<TNtfctns...>::Reset()
+{
+	m_nHasValue = 0;
+	m_nFired = 0;
+	Cancel();
+	OnReset();
+}
+
+template <class... TNtfctns>
+inline void TCombinatorBase<TNtfctns...>::Detach()
+{
+	std::apply([](auto&... oInputs) {(oInputs.DisconnectAll(), ...);}, m_tInputs);
+	Cancel();
+}
+
+template <class... TNtfctns>
+inline void TCombinatorBase<TNtfctns...>::Attach()
+{
+	AttachInputs(std::index_sequence_for<TNtfctns...>());
+}
+
+template <class... TNtfctns>
+template <size_t tIdx, typename... TArguments>
+inline void TCombinatorBase<TNtfctns...>::OnInput(TArguments... args)
+{
+	using ValueType = std::tuple_element_t<tIdx, ValuesType>;
+	std::get<tIdx>(m_tValues) = ValueType(args...);
+	m_nHasValue |= uint64_t(1) << tIdx;
+	m_nFired |= uint64_t(1) << tIdx;
+	m_nLastInput = tIdx;
+
+	// Inputs are invoked by the emissions, so the cascade is in progress and the result waits for its end
+	if (!Schedule())
+		OnCascadeEnd();
+}
+
+template <class... TNtfctns>
+template <size_t... tIdx>
+inline void TCombinatorBase<TNtfctns...>::AttachInputs(std::index_sequence<tIdx...>)
+{
+	// Inputs schedule the hook, so every emission reaching them opens the cascade
+	(std::get<tIdx>(m_tInputs).SetCascadeListener(true), ...);
+	(std::get<tIdx>(m_tInputs).Init(*std::get<tIdx>(m_tNotifications),
+									CombinatorInput<std::tuple_element_t<tIdx, std::tuple<TNtfctns...>>>::template MakeDelegate<tIdx>(*this)), ...);
+}
+
+template <class... TNtfctns>
+inline void TCombinatorBase<TNtfctns...>::OnCascadeEnd()
+{
+	if (m_nFired != 0)
+		OnInputsFired();
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TCombineLatest Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <class... TNtfctns>
+inline TCombineLatest<TNtfctns...>::TCombineLatest(typename CombinatorInput<TNtfctns>::NotificationType const&... oNtfctns) :
+	Base(oNtfctns...)
+{
+}
+
+template <class... TNtfctns>
+inline typename TCombineLatest<TNtfctns...>::NotificationType const& TCombineLatest<TNtfctns...>::GetNotification() const
+{
+	return m_oResult;
+}
+
+template <class... TNtfctns>
+inline void TCombineLatest<TNtfctns...>::OnInputsFired()
+{
+	this->m_nFired = 0;
+	if (this->m_nHasValue == Base::AllInputs())
+		Emit(std::index_sequence_for<TNtfctns...>());
+}
+
+template <class... TNtfctns>
+template <size_t... tIdx>
+inline void TCombineLatest<TNtfctns...>::Emit(std::index_sequence<tIdx...>)
+{
+	m_oResult.Notify(this, std::get<tIdx>(this->m_tValues)...);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TZip Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <class... TNtfctns>
+inline TZip<TNtfctns...>::TZip(typename CombinatorInput<TNtfctns>::NotificationType const&... oNtfctns) :
+	Base(oNtfctns...)
+{
+}
+
+template <class... TNtfctns>
+inline typename TZip<TNtfctns...>::NotificationType const& TZip<TNtfctns...>::GetNotification() const
+{
+	return m_oResult;
+}
+
+template <class... TNtfctns>
+inline uint64_t TZip<TNtfctns...>::GetOverwritten() const
+{
+	return m_nOverwritten;
+}
+
+template <class... TNtfctns>
+inline void TZip<TNtfctns...>::OnInputsFired()
+{
+	// Inputs coalesced within the cascade count once, inputs still waiting for the others are overwritten
+	for (uint64_t nAgain = m_nPending & this->m_nFired; nAgain != 0; nAgain &= nAgain - 1)
+		++m_nOverwritten;
+	m_nPending |= this->m_nFired;
+	this->m_nFired = 0;
+	if (m_nPending != Base::AllInputs())
+		return;
+
+	m_nPending = 0;
+	Emit(std::index_sequence_for<TNtfctns...>());
+}
+
+template <class... TNtfctns>
+inline void TZip<TNtfctns...>::OnReset()
+{
+	// Inputs fired before the reset do not count towards the next result
+	m_nPending = 0;
+}
+
+template <class... TNtfctns>
+template <size_t... tIdx>
+inline void TZip<TNtfctns...>::Emit(std::index_sequence<tIdx...>)
+{
+	m_oResult.Notify(this, std::get<tIdx>(this->m_tValues)...);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TMerge Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <class TNtfctn, class... TNtfctns>
+inline TMerge<TNtfctn, TNtfctns...>::TMerge(typename InputType::NotificationType const& oNtfctn,
+											typename CombinatorInput<TNtfctns>::NotificationType const&... oNtfctns) :
+	Base(oNtfctn, oNtfctns...)
+{
+}
+
+template <class TNtfctn, class... TNtfctns>
+inline typename TMerge<TNtfctn, TNtfctns...>::NotificationType const& TMerge<TNtfctn, TNtfctns...>::GetNotification() const
+{
+	return m_oResult;
+}
+
+template <class TNtfctn, class... TNtfctns>
+inline void TMerge<TNtfctn, TNtfctns...>::OnInputsFired()
+{
+	this->m_nFired = 0;
+	InputType::Emit(m_oResult, this, GetValue(this->m_nLastInput, std::index_sequence_for<TNtfctn, TNtfctns...>()));
+}
+
+template <class TNtfctn, class... TNtfctns>
+template <size_t... tIdx>
+inline typename TMerge<TNtfctn, TNtfctns...>::InputType::ValueType const&
+TMerge<TNtfctn, TNtfctns...>::GetValue(size_t nInput, std::index_sequence<tIdx...>) const
+{
+	// All values have the same type, so the runtime index selects among the tuple elements
+	typename InputType::ValueType const* apValues[] = {&std::get<tIdx>(this->m_tValues)...};
+	return *apValues[nInput];
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_COMBINE_H
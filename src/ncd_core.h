@@ -32,6 +32,8 @@
 //	Connection object tightly bound to its target object, ususally connection is a member of the receiver object
 //	But when connection object kept seperately from its target then it is responsibility of the Programmer
 //	to clear or destroyed it when target object destroyed, otherwise undefined behavoir (crash) could occour
+//	Notifications and connections are movable: links are rewired to the new address, and connection (notification)
+//	embedded into its receiver (sender) follows the relocated owner, so such objects could be kept in std::vector
 //
 //
 //	Usage example
@@ -86,26 +88,116 @@ CTarget::CTarget(CSender oSender)
 //
 //	Includes
 //
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <thread>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 #include <algorithm>
 #include <utility>
+#include <tuple>
+#include <type_traits>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // Defines - NCD stands as a prefix for the 'Notification - Connection - Delegate' scope
 //
+// Enforces constant initialization of the static objects where compiler supports it
+#if defined(__cpp_constinit)
+#define NCD_CONSTINIT constinit
+#else
+#define NCD_CONSTINIT
+#endif
+
+// Exception policy of the emissions, chosen at compile time by defining NCD_EXCEPTION_POLICY
+//	NCD_EXCEPTIONS_PROPAGATE - (default) exception thrown by the listener leaves Notify, remaining listeners are skipped,
+//		emission state (nesting, holes) is restored by the scope guards, blockers and muters are restored by their owners
+//	NCD_EXCEPTIONS_ISOLATE - exception is passed to the emission error sink and emission continues with the next listener
+//	NCD_EXCEPTIONS_TERMINATE - delegate stubs and emission loop are noexcept, throwing listener terminates the program,
+//		no exception handling landing pads are left on the emission path
+#define NCD_EXCEPTIONS_PROPAGATE	0
+#define NCD_EXCEPTIONS_ISOLATE		1
+#define NCD_EXCEPTIONS_TERMINATE	2
+
+#if !defined(NCD_EXCEPTION_POLICY)
+#define NCD_EXCEPTION_POLICY NCD_EXCEPTIONS_PROPAGATE
+#endif
+
+#if NCD_EXCEPTION_POLICY == NCD_EXCEPTIONS_TERMINATE
+#define NCD_EMIT_NOEXCEPT noexcept
+#else
+#define NCD_EMIT_NOEXCEPT
+#endif
+
+// Function pointer types could be noexcept since C++17
+#if NCD_EXCEPTION_POLICY == NCD_EXCEPTIONS_TERMINATE && defined(__cpp_noexcept_function_type)
+#define NCD_STUB_NOEXCEPT noexcept
+#else
+#define NCD_STUB_NOEXCEPT
+#endif
+
+// Static tracepoints (USDT) for SystemTap/bpftrace, compiled in when NCD_ENABLE_USDT is defined and <sys/sdt.h> exists
+// Probe site is a single nop while no tracer is attached, otherwise expands to nothing
+//	ncd:notify__entry(notification, connection count), ncd:notify__exit(notification)
+//	ncd:invoke(connection, delegate stub, delegate target)
+// Stub is shared by all connections of the same listener, the connection address tells which one is invoked,
+// so profiles attribute the invocations by the probe arguments rather than by the stub symbols
+#if defined(NCD_ENABLE_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define NCD_USDT_ENABLED
+#endif
+#endif
+
+#if defined(NCD_USDT_ENABLED)
+#define NCD_PROBE_NOTIFY_ENTRY(_Ntfctn_, _Count_)		DTRACE_PROBE2(ncd, notify__entry, _Ntfctn_, _Count_)
+#define NCD_PROBE_NOTIFY_EXIT(_Ntfctn_)					DTRACE_PROBE1(ncd, notify__exit, _Ntfctn_)
+#define NCD_PROBE_INVOKE(_Cnctn_, _Stub_, _Target_)		DTRACE_PROBE3(ncd, invoke, _Cnctn_, _Stub_, _Target_)
+#else
+#define NCD_PROBE_NOTIFY_ENTRY(_Ntfctn_, _Count_)
+#define NCD_PROBE_NOTIFY_EXIT(_Ntfctn_)
+#define NCD_PROBE_INVOKE(_Cnctn_, _Stub_, _Target_)
+#endif
+
+// Full signature of the enclosing function, used to name listeners and signatures
+#if defined(_MSC_VER)
+#define NCD_FUNCTION_SIGNATURE __FUNCSIG__
+#else
+#define NCD_FUNCTION_SIGNATURE __PRETTY_FUNCTION__
+#endif
+
+// Process-wide memory tallies by signature (see SMemoryTally), compiled in when NCD_ENABLE_MEMORY_TALLY is defined
+// Every notification and connection then keeps the pointer to the tally of its type
+#if defined(NCD_ENABLE_MEMORY_TALLY)
+#define NCD_MEMORY_TALLY_ENABLED
+#endif
+
+// Shrink policy (hysteresis): connection list of the notification having at least NCD_SHRINK_MIN_CAPACITY slots
+// is shrunk to the twice of its size once less than a quarter of the slots is used, so growing back and shrinking
+// again needs the size to change twice
+// Policy is applied when the list is compacted (holes erased), single removals never reallocate,
+// list emptied from its end and the notification set of the connection are shrunk by ShrinkToFit
+#if !defined(NCD_SHRINK_MIN_CAPACITY)
+#define NCD_SHRINK_MIN_CAPACITY 64
+#endif
+
 // Standartized connection name: cnt stands for the word 'connection'
 #define NCD_CONNECTION_NAME(_Listener_Name_)																		\
 	cnt_##_Listener_Name_
 
 // Connection declaration
 #define NCD_DECLARE_CONNECTION(_Listener_Name_)																		\
-	::ntf::Connection<decltype(&_Listener_Name_)>	NCD_CONNECTION_NAME(_Listener_Name_);
+	::ncd::Connection<decltype(&_Listener_Name_)>	NCD_CONNECTION_NAME(_Listener_Name_);
 
 // Workaround for the (TSender* pSender) issue, will be removed after switching VS 2017 compiler (waiting to C++17)
 #define NCD_DECLARE_CONNECTION2(_Listener_Name_)																	\
-	::ntf::Connection2<decltype(&_Listener_Name_)>	NCD_CONNECTION_NAME(_Listener_Name_);
+	::ncd::Connection2<decltype(&_Listener_Name_)>	NCD_CONNECTION_NAME(_Listener_Name_);
 
 // Connection initialization
 #define NCD_INIT_CONNECTION(_ClassName_, _Listener_Name_)															\
@@ -137,21 +229,13 @@ CTarget::CTarget(CSender oSender)
 
 // Static connection declaration
 #define NCD_DECLARE_CONNECTION_STATIC(_Listener_Name_)																\
-	static ::ntf::Connection<decltype(&_Listener_Name_)>	NCD_CONNECTION_NAME(_Listener_Name_);
+	static ::ncd::StaticConnection<decltype(&_Listener_Name_)>	NCD_CONNECTION_NAME(_Listener_Name_);
 
-// Static connection definition & initialization
+// Static connection definition & constant initialization (no startup code), connection is constructed upon the first use
 #define NCD_DEFINE_CONNECTION_STATIC(_ClassName_, _Listener_Name_)													\
-	::ntf::Connection<decltype(&_ClassName_::_Listener_Name_)>	_ClassName_::NCD_CONNECTION_NAME(_Listener_Name_);	\
-	class StaticConnectionInitializer_##_ClassName_##_##_Listener_Name_												\
-	{																												\
-		inline StaticConnectionInitializer_##_ClassName_##_##_Listener_Name_()										\
-		{																											\
-			_ClassName_::NCD_CONNECTION_NAME(_Listener_Name_).Init<&_ClassName_::_Listener_Name_>();				\
-		}																											\
-		StaticConnectionInitializer_##_ClassName_##_##_Listener_Name_ instance;										\
-	};																												\
-	StaticConnectionInitializer_##_ClassName_##_##_Listener_Name_													\
-		StaticConnectionInitializer_##_ClassName_##_##_Listener_Name_::instance;
+	NCD_CONSTINIT ::ncd::StaticConnection<decltype(&_ClassName_::_Listener_Name_)>									\
+		_ClassName_::NCD_CONNECTION_NAME(_Listener_Name_)															\
+		{::ncd::TStaticListener<decltype(&_ClassName_::_Listener_Name_), &_ClassName_::_Listener_Name_>()};
 
 #define NCD_INIT_CONNECTION_STATIC(_ClassName_, _Listener_Name_)													\
 	NCD_CONNECTION_NAME(_Listener_Name_).Init<&_ClassName_::_Listener_Name_>();
@@ -161,17 +245,54 @@ CTarget::CTarget(CSender oSender)
 
 // Connection scoped mute/unmute
 #define NCD_MUTE_CONNECTION(_Listener_Name_)																		\
-	::ntf::ConnectionMuter o##_Listener_Name_##Muter(MYM_CONNECTION_NAME(_Listener_Name_));
+	::ncd::ConnectionMuter o##_Listener_Name_##Muter(NCD_CONNECTION_NAME(_Listener_Name_));
 
 // Notifications scoped blocking
 #define NCD_BLOCK(_Ntfctn_)																							\
-	::ntf::NotificationBlocker o##_Ntfctn_##Blocker(_Ntfctn_);
+	::ncd::NotificationBlocker o##_Ntfctn_##Blocker(_Ntfctn_);
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 namespace ncd { // Notification - Connection - Delegate
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Owner offset
+//	Objects embedded into their owner (connection into the receiver, notification into the sender) keep pointer to it
+//	Position of the object in its owner is captured when the owner is bound, relocated object finds its relocated
+//	owner at the same offset. Object bound to the owner it does not lie in keeps the owner when relocated
+//
+class COwnerOffset
+{
+public:
+	inline constexpr COwnerOffset() = default;
+
+	// Captures position of the member in the owner of nOwnerSize bytes
+	inline void Capture(void const* pMember, void const* pOwner, size_t nOwnerSize)
+	{
+		char const* pOwnerBegin = static_cast<char const*>(pOwner);
+		char const* pAddress = static_cast<char const*>(pMember);
+		bool const bEmbedded = (pOwner != nullptr && pAddress >= pOwnerBegin && pAddress < pOwnerBegin + nOwnerSize);
+		m_nOffset = bEmbedded ? static_cast<uint32_t>(pAddress - pOwnerBegin) : c_nNotEmbedded;
+	}
+	// Forgets the captured position
+	inline void Reset()
+		{m_nOffset = c_nNotEmbedded;}
+
+	// Returns true if the member was captured inside its owner
+	inline bool IsEmbedded() const
+		{return (m_nOffset != c_nNotEmbedded);}
+	// Returns owner of the member placed at the specified address, null if the member is not embedded
+	inline void* GetOwner(void const* pMember) const
+		{return IsEmbedded() ? static_cast<char*>(const_cast<void*>(pMember)) - m_nOffset : nullptr;}
+
+private:
+	static constexpr uint32_t c_nNotEmbedded = UINT32_MAX;
+	uint32_t m_nOffset = c_nNotEmbedded;
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 //	Delegate
@@ -203,9 +324,9 @@ private:
 	// Internal constructor
 	using t_pobSender = void*;
 	using t_pobReceiver = void*;
-	using t_pfnCallback = TRetVal(*)(t_pobSender pSender, t_pobReceiver pReceiver, TArguments... args);
+	using t_pfnCallback = TRetVal(*)(t_pobSender pSender, t_pobReceiver pReceiver, TArguments... args) NCD_STUB_NOEXCEPT;
 
-	inline TDelegate(t_pobReceiver pTargetObject, t_pfnCallback pFunctionCaller) :
+	inline constexpr TDelegate(t_pobReceiver pTargetObject, t_pfnCallback pFunctionCaller) :
 		m_tCallback(pTargetObject, pFunctionCaller)
 		{}
 
@@ -226,7 +347,7 @@ public:
 
 	// Constructor for static TFunction(TArguments...)
 	template <TRetVal(*TFunction)(TArguments...)>
-	static TDelegate Create()
+	static constexpr TDelegate Create()
 		{return TDelegate((t_pobReceiver) nullptr, FunctionCaller<TFunction>);}
 
 	// Constructor for Lambda/TFunctor(TArguments...)
@@ -246,7 +367,7 @@ public:
 
 	// Constructor with Sender for static TFunction(TSender*, TArguments...)
 	template <typename TSender, TRetVal(*TFunction)(TSender*, TArguments...)>
-	static TDelegate CreateEx()
+	static constexpr TDelegate CreateEx()
 		{return TDelegate((t_pobReceiver) nullptr, FunctionCallerWithSender<TSender, TFunction>);}
 
 	// Constructor with Sender for TFunctor(TSender*, TArguments...)
@@ -277,7 +398,7 @@ public:
 		{m_tCallback != nullptr;}
 
 	template <typename TSender>
-	inline TRetVal operator () (TSender* pSender, TArguments... args) const
+	inline TRetVal operator () (TSender* pSender, TArguments... args) const NCD_STUB_NOEXCEPT
 		{return (*m_tCallback.pFunc)(pSender, m_tCallback.pObj, args...);}
 
 public:
@@ -287,6 +408,19 @@ public:
 	inline bool IsNull() const
 		{return (m_tCallback == nullptr);}
 
+	// Returns address of the caller stub and of the target object (tracing and symbolization)
+	inline void const* GetStub() const
+		{return reinterpret_cast<void const*>(m_tCallback.pFunc);}
+	inline void const* GetTarget() const
+		{return m_tCallback.pObj;}
+
+	// Rebinds to the new target object if the delegate is bound to the old one (relocated target)
+	inline void Rebind(void const* pOldTarget, void const* pNewTarget)
+	{
+		if (pOldTarget != nullptr && m_tCallback.pObj == pOldTarget)
+			m_tCallback.pObj = const_cast<void*>(pNewTarget);
+	}
+
 private:
 	//
 	//	Implementation
@@ -298,10 +432,10 @@ private:
 
 		inline SCallbackItem() = default;
 		inline SCallbackItem(SCallbackItem const&) = default;
-		inline SCallbackItem(SCallbackItem&& o) :
+		inline constexpr SCallbackItem(SCallbackItem&& o) :
 			pObj(o.pObj), pFunc(o.pFunc)
 			{o.pObj = nullptr; o.pFunc = nullptr;}
-		inline SCallbackItem(t_pobReceiver obj, t_pfnCallback fn) :
+		inline constexpr SCallbackItem(t_pobReceiver obj, t_pfnCallback fn) :
 			pObj(obj), pFunc(fn)
 			{}
 
@@ -325,54 +459,54 @@ private:
 	//	Caller stubs specialized for different use-cases
 	//
 	template <class TReceiver, TRetVal(TReceiver::*TMethod)(TArguments...)>
-	static TRetVal MethodCaller(t_pobSender, t_pobReceiver pObj, TArguments... args)
+	static TRetVal MethodCaller(t_pobSender, t_pobReceiver pObj, TArguments... args) NCD_STUB_NOEXCEPT
 	{
 		TReceiver* pTargetObj = static_cast<TReceiver*>(pObj);
 		return (pTargetObj->*TMethod)(args...);
 	}
 
 	template <class TReceiver, TRetVal(TReceiver::*TMethod)(TArguments...) const>
-	static TRetVal ConstMethodCaller(t_pobSender, t_pobReceiver pObj, TArguments... args)
+	static TRetVal ConstMethodCaller(t_pobSender, t_pobReceiver pObj, TArguments... args) NCD_STUB_NOEXCEPT
 	{
 		TReceiver const* pTargetObj = static_cast<TReceiver*>(pObj);
 		return (pTargetObj->*TMethod)(args...);
 	}
 
 	template <TRetVal(*TMethod)(TArguments...)>
-	static TRetVal FunctionCaller(t_pobSender, t_pobReceiver, TArguments... args)
+	static TRetVal FunctionCaller(t_pobSender, t_pobReceiver, TArguments... args) NCD_STUB_NOEXCEPT
 	{
 		return (TMethod) (args...);
 	}
 
 	template <typename TFunctor>
-	static TRetVal FunctorCaller(t_pobSender, t_pobReceiver pObj, TArguments... args)
+	static TRetVal FunctorCaller(t_pobSender, t_pobReceiver pObj, TArguments... args) NCD_STUB_NOEXCEPT
 	{
 		TFunctor* pFuncObj = static_cast<TFunctor*>(pObj);
 		return (pFuncObj->operator())(args...);
 	}
 
 	template <class TSender, class TReceiver, TRetVal(TReceiver::*TMethod)(TSender*, TArguments...)>
-	static TRetVal MethodCallerWithSender(t_pobSender pSender, t_pobReceiver pObj, TArguments... args)
+	static TRetVal MethodCallerWithSender(t_pobSender pSender, t_pobReceiver pObj, TArguments... args) NCD_STUB_NOEXCEPT
 	{
 		TReceiver* pTargetObj = static_cast<TReceiver*>(pObj);
 		return (pTargetObj->*TMethod)(static_cast<TSender*>(pSender), args...);
 	}
 
 	template <class TSender, class TReceiver, TRetVal(TReceiver::*TMethod)(TSender*, TArguments...) const>
-	static TRetVal ConstMethodCallerWithSender(t_pobSender pSender, t_pobReceiver pObj, TArguments... args)
+	static TRetVal ConstMethodCallerWithSender(t_pobSender pSender, t_pobReceiver pObj, TArguments... args) NCD_STUB_NOEXCEPT
 	{
 		TReceiver const* pTargetObj = static_cast<TReceiver*>(pObj);
 		return (pTargetObj->*TMethod)(static_cast<TSender*>(pSender), args...);
 	}
 
 	template <class TSender, TRetVal(*TMethod)(TSender*, TArguments...)>
-	static TRetVal FunctionCallerWithSender(t_pobSender pSender, t_pobReceiver, TArguments... args)
+	static TRetVal FunctionCallerWithSender(t_pobSender pSender, t_pobReceiver, TArguments... args) NCD_STUB_NOEXCEPT
 	{
 		return (TMethod) (static_cast<TSender*>(pSender), args...);
 	}
 
 	template <class TSender, typename Functor>
-	static TRetVal FunctorCallerWithSender(t_pobSender pSender, t_pobReceiver pObj, TArguments... args)
+	static TRetVal FunctorCallerWithSender(t_pobSender pSender, t_pobReceiver pObj, TArguments... args) NCD_STUB_NOEXCEPT
 	{
 		Functor* pFuncObj = static_cast<Functor*>(pObj);
 		return (pFuncObj->operator())(static_cast<TSender*>(pSender), args...);
@@ -386,6 +520,41 @@ private:
 
 // Forward declaration of the Base class for connection objects
 class CConnectionBase;
+// Forward declaration of the cascade end callback
+class CCascadeHook;
+// Forward declaration of the notification observer
+class CNotificationHook;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	SMemoryTally
+//	Process-wide memory used by the notifications (or connections) of one signature
+//	Tallies are created upon the first object of the type and live until the process ends
+//
+struct SMemoryTally
+{
+	inline SMemoryTally(char const* szSignature, size_t nObjectSize);
+
+	SMemoryTally(SMemoryTally const&) = delete;
+	void operator=(SMemoryTally const&) = delete;
+
+	// Returns total memory: live objects and the lower bound of their heap memory (see MemoryUsage)
+	inline int64_t GetTotalBytes() const;
+
+	char const* const		szSignature;
+	size_t const			nObjectSize;
+	std::atomic<int64_t>	nObjects {0};
+	std::atomic<int64_t>	nHeapBytes {0};
+	SMemoryTally*			pNext = nullptr;
+};
+
+// Returns tally of the type (TNotification<...> or TConnection<...>), registers it upon the first call
+template <typename TObject>
+inline SMemoryTally& MemoryTallyOf();
+// Calls fnVisitor(SMemoryTally const&) for every registered tally
+template <typename TVisitor>
+inline void ForEachMemoryTally(TVisitor&& fnVisitor);
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -403,10 +572,12 @@ protected:
 	inline CNotificationBase() = default;
 
 	CNotificationBase(CNotificationBase const&) = delete;
-	CNotificationBase(CNotificationBase&&) = delete;
-
 	void operator=(CNotificationBase const&) = delete;
-	void operator=(CNotificationBase&&) = delete;
+
+	// Relocation, connections are rewired to the new address keeping their order
+	// Notification should not be moved while it is emitting
+	inline CNotificationBase(CNotificationBase&& other);
+	inline CNotificationBase& operator=(CNotificationBase&& other);
 
 public:
 	inline ~CNotificationBase();
@@ -418,6 +589,9 @@ public:
 
 	// Returns true if the notification hac active connections
 	inline bool HasConnections() const;
+	// Returns true if the emission would invoke any listener: notification is not blocked and has unmuted connections
+	// Answered in O(1), chained notification counts as the listener regardless of its own connections
+	inline bool HasActiveListeners() const;
 	// Returns true if the specified connection is connected to this Notification
 	inline bool IsConnected(CConnectionBase const& oCnctn) const;
 
@@ -426,6 +600,20 @@ public:
 	inline bool RemoveConnection(CConnectionBase const& oCnctn) const;
 	// Removes all connections
 	inline void RemoveAllConnections() const;
+	// Removes all connections in the range [itFirst, itLast) with single compaction pass
+	// Range elements should be pointers to connections (CConnectionBase const*)
+	template <typename TIterator>
+	inline void RemoveConnections(TIterator itFirst, TIterator itLast) const;
+
+	// Calls fnVisitor(CConnectionBase const&) for every connection (graph introspection)
+	template <typename TVisitor>
+	inline void ForEachConnection(TVisitor&& fnVisitor) const;
+
+	// Returns lower bound of the heap memory held by the notification (capacity of the connection list),
+	// allocator overhead and the object itself are not counted
+	inline size_t MemoryUsage() const;
+	// Releases unused capacity of the connection list, does nothing while emitting
+	inline void ShrinkToFit() const;
 
 	///////////////////////////////////////////////////////////////////////////////
 	//
@@ -466,15 +654,113 @@ protected:
 	//
 	//	Implementation
 	//
-	inline void Add(CConnectionBase const* pCnctn) const;
-	inline bool Remove(CConnectionBase const* pCnctn) const;
+	// Links both sides, connection which is already linked is moved to the end of the invocation order if bMoveToEnd
+	inline void Link(CConnectionBase const& oCnctn, bool bMoveToEnd) const;
+	// Unlinks both sides in constant time, returns false if the connection is not linked
+	inline bool Unlink(CConnectionBase const& oCnctn) const;
+	// Releases the slot of the unlinked connection at specified position, leaves a hole in its place
+	// Holes are erased when the emission ends or once they make up the half of the list
+	inline void ReleaseSlot(size_t nIdx) const;
+	// Links both sides, keeps connection at the end of the invocation order
+	inline void LinkConnection(CConnectionBase const& oCnctn) const;
+	// Takes over all connections of the other notification (relocation)
+	inline void TakeConnections(CNotificationBase& other);
+	// Replaces relocated connection at its position
+	inline void ReplaceConnection(size_t nIdx, CConnectionBase const* pNew) const;
+	// Erases all connections marked as retiring with a single pass
+	inline void Compact() const;
+	// Erases holes left by the removals, survivors learn their new positions
+	inline void EraseHoles() const;
+	// Counts invocation of the shot limited connection at specified position (called while emitting)
+	// Connection which used its last shot is unlinked in place, without searching
+	inline void ConsumeShot(size_t nIdx) const;
+	// Applies the shrink policy upon compaction (not while emitting)
+	inline void ApplyShrinkPolicy() const;
+	// Reallocates connection list with the specified capacity (not less than its size)
+	inline void Reallocate(size_t nCapacity) const;
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	// Counts the notification in the tally of its signature
+	inline void AttachTally(SMemoryTally& oTally);
+#endif
+	// Brings the tally in line with the current heap memory (does nothing without the tally)
+	inline void Retally() const;
+
+	//	Emission epoch of the thread: advanced by every top-level tracked emission, shared by the nested ones
+	//	Emission is tracked if the notification has connections which need it (see CConnectionBase::IsTracked),
+	//	plain emissions leave the epoch and the depth of the thread untouched
+	//	Epochs are unique process-wide, threads take them from the shared counter in blocks (one atomic per block),
+	//	so the emission made on one thread never takes the epoch stamped by the emission made on another one
+	//	Epochs are 64-bit, so they never wrap around and a stale stamp is never taken for the current one
+	//	Deduplicated connections remember the epoch of their last invocation
+	//	Cascade hooks scheduled during the epoch are queued until its top-level emission ends
+	struct SEpoch
+	{
+		uint64_t nCurrent = 0;
+		uint64_t nBlockEnd = 1;
+		uint32_t nDepth = 0;
+		CCascadeHook* pFirstHook = nullptr;
+		CCascadeHook* pLastHook = nullptr;
+	};
+	static inline SEpoch& ThreadEpoch();
+	// Takes the next block of epochs for the thread
+	static inline void TakeEpochBlock(SEpoch& oEpoch);
+	static constexpr uint64_t c_nEpochBlock = 1024;
+	// Runs cascade hooks scheduled on the thread if no emission is in progress there
+	static inline void EndCascade(SEpoch& oEpoch);
+	// Stamps deduplicated connection with the current epoch, returns false if it is already invoked within it
+	static inline bool EnterEpoch(SEpoch const& oEpoch, CConnectionBase const& oCnctn);
+
+	//
+	//	Scoped emission marker
+	//	While emission is in progress removed connections leave holes (null entries) in place,
+	//	so the emitting loop stays valid, holes are erased when the outermost emission ends
+	//	Only the tracked emission enters the epoch of the thread
+	//
+	class CEmitScope
+	{
+	public:
+		inline CEmitScope(CNotificationBase const& oNtfctn);
+		inline ~CEmitScope();
+
+		CEmitScope(CEmitScope const&) = delete;
+		void operator=(CEmitScope const&) = delete;
+
+		// Returns epoch of the thread if the emission is tracked, otherwise null
+		inline SEpoch* GetEpoch() const;
+		// Returns epoch of the thread if this is the top-level tracked emission (which ends the cascade), otherwise null
+		inline SEpoch* GetCascade() const;
+
+	private:
+		CNotificationBase const&	m_oNtfctn;
+		SEpoch* const				m_pEpoch;
+	};
+
+	friend class CConnectionBase;
+	friend class CConnectionGroup;
+	friend class CCascadeHook;
 
 protected:
 	//
 	// Contents
 	//
 	bool m_blocked = false;
+	// Marks notification as already scheduled for compaction during bulk teardown
+	mutable bool m_bCompactPending = false;
+	// Nesting level of emissions in progress and number of holes left by removals made during them
+	mutable uint32_t m_nEmitDepth = 0;
+	mutable uint32_t m_nHoles = 0;
+	// Number of linked connections which are not muted (kept up to date by the connections upon muting)
+	mutable uint32_t m_nActive = 0;
+	// Number of linked connections which need the emission to be tracked (kept up to date by the connections)
+	mutable uint32_t m_nTracked = 0;
 	mutable std::vector<CConnectionBase const*> m_aConnections;
+	// Observer of the links and emissions installed by the derived notification (stays with the object on move)
+	CNotificationHook const* m_pHook = nullptr;
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	// Tally of the signature and the heap memory accounted there
+	SMemoryTally* m_pTally = nullptr;
+	mutable size_t m_nTalliedBytes = 0;
+#endif
 };
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -490,10 +776,11 @@ protected:
 	inline CConnectionBase() = default;
 
 	CConnectionBase(CConnectionBase const&) = delete;
-	CConnectionBase(CConnectionBase&&) = delete;
-
 	void operator=(CConnectionBase const&) = delete;
-	void operator=(CConnectionBase&&) = delete;
+
+	// Relocation, notifications are rewired to the new address keeping invocation order
+	inline CConnectionBase(CConnectionBase&& other);
+	inline CConnectionBase& operator=(CConnectionBase&& other);
 
 public:
 	inline ~CConnectionBase();
@@ -508,6 +795,20 @@ public:
 	// Returns true if specified Notification is connected
 	inline bool IsConnected(CNotificationBase const& oNtfctn) const;
 
+	// Calls fnVisitor(CNotificationBase const&) for every connected Notification (graph introspection)
+	template <typename TVisitor>
+	inline void ForEachNotification(TVisitor&& fnVisitor) const;
+	// Returns Notification emitted by this connection if it is cnt_Notify of that Notification, otherwise null
+	// (the target is known to the chain connection which allocated this one, see TChainConnection)
+	inline CNotificationBase const* GetForwardTarget() const;
+
+	// Returns lower bound of the heap memory held by the connection (set of connected notifications): bucket pointers
+	// and node values, the node links and the allocator overhead of the standard library are not counted,
+	// nor is the object itself
+	inline size_t MemoryUsage() const;
+	// Releases unused buckets of the notification set (removals keep them)
+	inline void ShrinkToFit() const;
+
 	// Disconnectes from the specified Notification
 	inline bool Disconnect(CNotificationBase const& oNtfctn) const;
 	// Disconnectes from all connected Notifications
@@ -538,6 +839,30 @@ public:
 	};
 	///////////////////////////////////////////////////////////////////////////////
 
+	// Limits number of invocations made by the Notification, after the last one connection disconnects itself
+	// Shots are counted per connection, so limited connection is linked to a single Notification:
+	// returns false and keeps the limit unchanged if the connection is linked to several Notifications,
+	// limited connection should not be linked to other Notifications (asserts and ignores such link)
+	// Zero means unlimited, limit is not restored upon reconnection
+	inline bool SetShotLimit(uint32_t nShots);
+	// Returns remaining number of invocations or zero if unlimited
+	inline uint32_t GetShotsLeft() const;
+
+	// Deduplicated connection is invoked at most once per top-level emission,
+	// even if it is reachable through several chained paths (diamond shaped graphs)
+	// Nested emissions made by listeners belong to the same top-level emission, if that one is tracked (see IsTracked)
+	inline void SetDeduplicated(bool bDedup);
+	inline bool IsDeduplicated() const;
+
+	// Cascade listener schedules CCascadeHook from its delegate, so the emissions reaching it open the cascade
+	// (plain emissions, which reach no tracked connection, do not, see IsTracked)
+	inline void SetCascadeListener(bool bCascade);
+	inline bool IsCascadeListener() const;
+
+	// Returns true if the emissions reaching the connection should be tracked on the thread: connection is
+	// deduplicated, shot limited, cascade listener or chaining (its target could reach such connections)
+	inline bool IsTracked() const;
+
 	// Returns connections Muted (enabled/disabled) state
 	inline bool IsMuted() const;
 	// Sets Connection muted state accordingly, returns previous state 
@@ -549,18 +874,193 @@ protected:
 	//
 	//	Implementation
 	//
-	inline void Add(CNotificationBase const* pNtfctn) const;
+	// Forgets specified notification (the notification side is unlinked by the caller)
 	inline bool Remove(CNotificationBase const* pNtfctn) const;
+	// Links both sides, notification which already has this connection keeps its order
+	inline void LinkNotification(CNotificationBase const& oNtfctn) const;
+	// Returns false if the connection is shot limited and linked to other Notification than specified
+	inline bool AcceptsLink(CNotificationBase const& oNtfctn) const;
+	// Forward target slot of the connection allocated by TChainConnection (kept in front of the connection)
+	inline CNotificationBase const*& ForwardTargetSlot() const;
+	static constexpr size_t c_nForwardHeaderSize = alignof(std::max_align_t);
+	// Takes over all notifications of the other connection (relocation)
+	inline void TakeNotifications(CConnectionBase& other);
+	// Replaces relocated notification, the connection is listed there at specified position
+	inline void ReplaceNotification(CNotificationBase const* pOld, CNotificationBase const* pNew, size_t nIdx) const;
+	// Keeps tracked connection counts of the linked notifications in line once the connection has (not) become tracked
+	inline void UpdateTracked(bool bWasTracked) const;
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	// Counts the connection in the tally of its signature
+	inline void AttachTally(SMemoryTally& oTally);
+#endif
+	// Brings the tally in line with the current heap memory (does nothing without the tally)
+	inline void Retally() const;
+
+	friend class CNotificationBase;
+	friend class CConnectionGroup;
+	template <typename... TArguments>
+	friend class TChainConnection;
 
 protected:
 	// Controls connection enabled/disabled state
 	// Notifications could stay connected but if the connection is not enabledit should not pass calls to the delegate
 	bool m_bMuted = false;
-	// Set of connected Notifications (senders)
-	mutable std::unordered_set<CNotificationBase const*> m_setConnections;
+	// Marks connection as being removed by bulk teardown, notifications drop marked connections on compaction
+	mutable bool m_bRetiring = false;
+	// Marks cnt_Notify connection allocated by TChainConnection, its forward target precedes it in the same block
+	bool m_bForward = false;
+	// Emission deduplication state (the epoch of the last invocation follows)
+	bool m_bDedup = false;
+	// Marks connection scheduling cascade hooks
+	bool m_bCascade = false;
+	// Remaining number of invocations for the one-shot/N-shot connections, zero means unlimited
+	mutable uint32_t m_nShotsLeft = 0;
+	mutable uint64_t m_nEpoch = 0;
+	// Connected Notifications (senders) and the position of the connection in the list of each one,
+	// so the connection is unlinked without searching
+	mutable std::unordered_map<CNotificationBase const*, size_t> m_mapConnections;
+#if !defined(NDEBUG)
+	// Number of groups listing the connection, it should be removed from them before it is destroyed or moved
+	mutable size_t m_nGroups = 0;
+#endif
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	// Tally of the signature and the heap memory accounted there
+	SMemoryTally* m_pTally = nullptr;
+	mutable size_t m_nTalliedBytes = 0;
+#endif
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CConnectionGroup
+//	Collects connections to tear them down together
+//	Disconnecting k connections costs O(k) plus a single compaction pass per affected Notification
+//	instead of a search & erase per link (quadratic when many receivers listen the same Notification)
+//	Group does not own its connections, they should be removed from the group or outlive it,
+//	usually the group is declared after the connections it collects so it is destroyed first
+//	Debug build asserts that the connection is not destroyed or moved while it is listed in a group
+//
+class CConnectionGroup
+{
+public:
+	inline CConnectionGroup() = default;
+	inline ~CConnectionGroup();
+
+	CConnectionGroup(CConnectionGroup const&) = delete;
+	void operator=(CConnectionGroup const&) = delete;
+
+public:
+	//
+	// Methods
+	//
+
+	// Returns true if group has no connections
+	inline bool IsEmpty() const;
+	// Returns number of connections in the group
+	inline size_t GetSize() const;
+
+	// Adds specified connection to the group, if connection already exist does nothing (constant time)
+	inline void Add(CConnectionBase const& oCnctn);
+	// Removes specified connection from the group without disconnecting it
+	inline bool Remove(CConnectionBase const& oCnctn);
+	// Forgets all connections without disconnecting them
+	inline void Clear();
+
+	// Disconnects all connections of the group from all their notifications and clears the group
+	inline void DisconnectAll();
+
+	inline CConnectionGroup& operator += (CConnectionBase const& oCnctn);
+	inline CConnectionGroup& operator -= (CConnectionBase const& oCnctn);
+
+private:
+	// Contents
+	std::unordered_set<CConnectionBase const*> m_setConnections;
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CCascadeHook
+//	Callback invoked once when the cascade (top-level emission of the thread with all nested ones) ends
+//	Lets the listener coalesce several invocations made within one cascade into a single reaction
+//	Hook scheduled outside of any tracked emission is not queued, the caller should react at once
+//	(listener scheduling hooks marks its connection with SetCascadeListener)
+//	If a listener throws out of the cascade, scheduled hooks wait for the end of the next one
+//
+class CCascadeHook
+{
+public:
+	inline CCascadeHook() = default;
+	inline virtual ~CCascadeHook();
+
+	CCascadeHook(CCascadeHook const&) = delete;
+	void operator=(CCascadeHook const&) = delete;
+
+	// Queues the hook until the end of the current cascade, already queued hook stays in place
+	// Returns false if the calling thread is not in a tracked emission (hook is not queued)
+	inline bool Schedule();
+	// Removes the hook from the queue of the calling thread
+	inline void Cancel();
+	// Returns true if the hook is queued
+	inline bool IsScheduled() const;
+
+protected:
+	// Called by the thread which scheduled the hook, after its cascade ended
+	virtual void OnCascadeEnd() = 0;
+
+	friend class CNotificationBase;
+
+private:
+	// Contents
+	CCascadeHook*	m_pNextHook = nullptr;
+	bool			m_bScheduled = false;
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CNotificationHook
+//	Observer installed by the notification on itself (see TNotification::SetHook), so it acts upon every new link
+//	and every emission no matter whether they are made through the derived notification, its base or a chain
+//	Hooked notification emitted lazily always calls the producer, since the hook observes the emission
+//
+class CNotificationHook
+{
+public:
+	inline CNotificationHook() = default;
+	inline virtual ~CNotificationHook() = default;
+
+	CNotificationHook(CNotificationHook const&) = delete;
+	void operator=(CNotificationHook const&) = delete;
+
+	// Called after the connection is linked to the notification (not when already linked one is moved to the end)
+	virtual void OnLinked(CConnectionBase const& oCnctn) const = 0;
+};
+
+// Typed part of the hook, called upon every emission before the connections, even if the notification is blocked
+template <typename... TArguments>
+class TNotificationHook : public CNotificationHook
+{
+public:
+	virtual void OnEmit(void* pSender, TArguments... args) const = 0;
 };
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Emission error sink
+//	Receives exceptions thrown by the listeners under NCD_EXCEPTIONS_ISOLATE policy, should not throw itself
+//	Without the sink exceptions are swallowed
+//
+using FnEmissionErrorSink = void(*)(std::exception_ptr pError, CNotificationBase const& oNtfctn, CConnectionBase const& oCnctn);
+
+// Installs the sink (process-wide), returns previous one
+inline FnEmissionErrorSink SetEmissionErrorSink(FnEmissionErrorSink fnSink);
+// Passes the exception to the installed sink
+inline void ReportEmissionError(std::exception_ptr pError, CNotificationBase const& oNtfctn, CConnectionBase const& oCnctn);
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 // Notification class forward declaration
 template <typename ...TArguments>
 class TNotification;
@@ -581,10 +1081,16 @@ public:
 	using DelegateType = TDelegate<void(TArguments...)>;
 	using NotificationType = TNotification<TArguments...>;
 
-	inline TConnection() = default;
+	inline TConnection();
 	inline TConnection(DelegateType oDelegate);
 	inline TConnection(NotificationType const& oNtfctn, DelegateType oDelegate);
 
+protected:
+	// Relocation is left to the connections which know their receiver (TConnectionX/TConnectionX2 rebind the delegate),
+	// plain connection could not tell whether the target of its delegate moved along with it
+	inline TConnection(TConnection&& other) = default;
+	inline TConnection& operator=(TConnection&& other) = default;
+
 public:
 	//
 	//	Methods
@@ -596,11 +1102,23 @@ public:
 
 	// Connects specified notification to the associated delegate, if the Notification already connected does nothing
 	inline void Connect(NotificationType const& oNtfctn) const;
+	// Connects specified notification and disconnects automatically after the first invocation
+	// Returns false and does nothing if the connection is linked to other notifications (see SetShotLimit)
+	inline bool ConnectOnce(NotificationType const& oNtfctn);
+	// Connects specified notification and disconnects automatically after nShots invocations
+	// Returns false and does nothing if the connection is linked to other notifications (see SetShotLimit)
+	inline bool ConnectShots(NotificationType const& oNtfctn, uint32_t nShots);
 
 	// Invokes associated delegate with specifed arguments
 	// Usually this method called by corresponding Notifications conntected to this connection
 	template <typename TSender>
-	inline void Invoke(TSender* pSenderObject, TArguments... args) const;
+	inline void Invoke(TSender* pSenderObject, TArguments... args) const NCD_EMIT_NOEXCEPT;
+	// Returns associated delegate
+	inline DelegateType const& GetDelegate() const;
+
+	// Called after relocation of the delegate target object from pOldTarget to pNewTarget,
+	// rebinds the delegate if it is bound to the old target (does nothing for the null pOldTarget)
+	inline void RebindTarget(void const* pOldTarget, void const* pNewTarget);
 
 private:
 	// Contents
@@ -616,6 +1134,247 @@ template <typename TCallable> class TConnectionX;
 template <typename TCallable> class TConnectionX2;
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Static connection
+//	Connection to the static function which could be constant initialized (constexpr/constinit)
+//	Keeps only the delegate until the first use, the connection itself is constructed in place on demand,
+//	so static listeners cost no constructor calls at the process startup and have no initialization order issues
+//
+
+// Tag which passes the static function to the constant constructor
+template <typename TFunctionType, TFunctionType TFunction>
+struct TStaticListener {};
+
+template <typename TCallable> class TStaticConnection;
+
+template <typename... TArguments>
+class TStaticConnection<void(*)(TArguments...)>
+{
+public:
+	//	Type definitions
+	using ConnectionType = TConnection<TArguments...>;
+	using DelegateType = typename ConnectionType::DelegateType;
+	using NotificationType = typename ConnectionType::NotificationType;
+
+	//	Constructors
+	inline constexpr TStaticConnection() = default;
+	template <void(*TFunction)(TArguments...)>
+	inline constexpr TStaticConnection(TStaticListener<void(*)(TArguments...), TFunction>) :
+		m_oDelegate(DelegateType::template Create<TFunction>())
+		{}
+	// Destructor is trivial, so static connections do not register exit time destruction
+	// Constructed connection is never destroyed, notifications drop their links to it upon their own destruction
+	// Its links to the notifications still connected at exit stay allocated: they are reachable from the static
+	// object, so LeakSanitizer does not report them and valgrind lists them as "still reachable", not as leaked.
+	// Get().DisconnectAll() and Get().ShrinkToFit() before exit release them
+	inline ~TStaticConnection() = default;
+
+	TStaticConnection(TStaticConnection const&) = delete;
+	void operator=(TStaticConnection const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Initializers (replace the listener)
+	// Unconstructed connection is constructed with the specified listener under the construction flag,
+	// constructed one is reinitialized, which (as for any connection) should not race with its other uses
+	template <void(*TFunction)(TArguments...)>
+	inline void Init();
+	template <void(*TFunction)(TArguments...)>
+	inline void Init(NotificationType const& oNtfctn);
+
+	// Returns the connection, constructs it upon the first call (thread safe, afterwards costs a single load)
+	inline ConnectionType& Get() const;
+	inline operator ConnectionType const& () const;
+	// Returns true if the connection is already constructed
+	inline bool IsConstructed() const;
+
+	// Connects specified notification (constructs the connection if needed)
+	inline void Connect(NotificationType const& oNtfctn) const;
+	// Disconnects from the specified or all notifications, does not construct the connection
+	inline bool Disconnect(CNotificationBase const& oNtfctn) const;
+	inline void DisconnectAll() const;
+
+private:
+	// Constructs the connection with the specified delegate by the first caller, concurrent callers block until
+	// it is constructed, returns true if this call constructed it
+	inline bool Construct(DelegateType const& oDelegate) const;
+
+	// Contents
+	DelegateType									m_oDelegate;	// Constant initialized listener, never changes
+	mutable std::once_flag							m_oConstruct;
+	mutable std::atomic<bool>						m_bConstructed {false};
+	alignas(ConnectionType) mutable unsigned char	m_aStorage[sizeof(ConnectionType)] = {};
+};
+
+// Constructs specified static connections in a single pass (e.g. at the start of main), instead of on the first use
+template <typename... TStaticCnctns>
+inline void ConstructStaticConnections(TStaticCnctns const&... oCnctns);
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Chain connection
+//	Embedded into the TNotificationX as cnt_Notify to link Notifications with same arguments
+//	Keeps only the delegate until chaining is used, the connection itself is allocated on demand,
+//	so plain notifications pay only for their connection list
+//	Offers the TConnection interface: methods which link or configure the connection (Connect, Init with
+//	the notification, shot limits, deduplication, muting, Get and the conversion to TConnection&) allocate it
+//	upon the first call, queries, disconnects and Invoke do not
+//
+template <typename... TArguments>
+class TChainConnection
+{
+public:
+	//	Type definitions
+	using ConnectionType = TConnection<TArguments...>;
+	using DelegateType = typename ConnectionType::DelegateType;
+	using NotificationType = typename ConnectionType::NotificationType;
+
+	//	Constructors
+	inline TChainConnection() = default;
+	inline ~TChainConnection();
+	// Relocation, allocated connection stays in place
+	inline TChainConnection(TChainConnection&& other);
+	inline TChainConnection& operator=(TChainConnection&& other);
+
+	TChainConnection(TChainConnection const&) = delete;
+	void operator=(TChainConnection const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Initializers, as TConnection::Init (the first one does not allocate the connection)
+	inline void Init(DelegateType const& oDelegate);
+	inline void Init(NotificationType const& oNtfctn, DelegateType const& oDelegate);
+
+	// Returns the connection, allocates it upon the first call
+	inline ConnectionType& Get() const;
+	inline operator ConnectionType& ();
+	inline operator ConnectionType const& () const;
+	// Returns true if the connection is allocated
+	inline bool IsAllocated() const;
+	// Returns lower bound of the heap memory held by the allocated connection (including the connection itself)
+	inline size_t MemoryUsage() const;
+
+	// Connection interface, querying and disconnecting methods do not allocate the connection
+	inline void Connect(NotificationType const& oNtfctn) const;
+	inline bool Disconnect(CNotificationBase const& oNtfctn) const;
+	inline void DisconnectAll() const;
+	inline bool IsConnected(CNotificationBase const& oNtfctn) const;
+	inline bool HasConnectedNotifications() const;
+	inline bool IsMuted() const;
+	inline bool SetMuteState(bool bMute);
+	inline CConnectionBase::CMuter Mute();
+	inline bool ConnectOnce(NotificationType const& oNtfctn);
+	inline bool ConnectShots(NotificationType const& oNtfctn, uint32_t nShots);
+	inline bool SetShotLimit(uint32_t nShots);
+	inline uint32_t GetShotsLeft() const;
+	inline void SetDeduplicated(bool bDedup);
+	inline bool IsDeduplicated() const;
+	inline void ShrinkToFit() const;
+	template <typename TSender>
+	inline void Invoke(TSender* pSenderObject, TArguments... args) const NCD_EMIT_NOEXCEPT;
+	inline DelegateType const& GetDelegate() const;
+
+	// Rebinds the delegate upon the relocation of its target (see TConnection::RebindTarget)
+	inline void RebindTarget(void const* pOldTarget, void const* pNewTarget);
+
+private:
+	template <class TSender, typename... TArgs>
+	friend class TNotificationX;
+
+	// Sets the notification emitted by this connection (forward target of the allocated connection)
+	inline void SetOwner(CNotificationBase const* pOwner);
+	// Destroys the allocated connection and frees its block
+	inline void Free();
+
+	// Contents
+	DelegateType				m_oDelegate;
+	CNotificationBase const*	m_pOwner = nullptr;		// Notification emitted by this connection
+	mutable ConnectionType*		m_pCnctn = nullptr;
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Argument pack
+//	Keeps decayed copies of the emission arguments
+//	Unlike std::tuple it is trivially copyable when all arguments are, so it could be copied as raw bytes
+//
+template <size_t tIdx, typename TValue>
+struct TArgumentLeaf
+{
+	TValue tValue;
+};
+
+template <typename TIndexes, typename... TArguments>
+class TArgumentPackImpl;
+
+template <size_t... tIdx, typename... TArguments>
+class TArgumentPackImpl<std::index_sequence<tIdx...>, TArguments...> : TArgumentLeaf<tIdx, std::decay_t<TArguments>>...
+{
+public:
+	using TupleType = std::tuple<std::decay_t<TArguments>...>;
+
+	inline TArgumentPackImpl() = default;
+	inline explicit TArgumentPackImpl(TArguments... args) :
+		TArgumentLeaf<tIdx, std::decay_t<TArguments>>{args}...
+		{}
+
+	// Access to the stored argument by index
+	template <size_t tIndex>
+	inline std::tuple_element_t<tIndex, TupleType>& Get()
+		{return static_cast<TArgumentLeaf<tIndex, std::tuple_element_t<tIndex, TupleType>>&>(*this).tValue;}
+	template <size_t tIndex>
+	inline std::tuple_element_t<tIndex, TupleType> const& Get() const
+		{return static_cast<TArgumentLeaf<tIndex, std::tuple_element_t<tIndex, TupleType>> const&>(*this).tValue;}
+
+	// Invokes specified connection with the stored arguments
+	template <typename TSender>
+	inline void Invoke(TConnection<TArguments...> const& oCnctn, TSender* pSender)
+		{oCnctn.template Invoke<TSender>(pSender, Get<tIdx>()...);}
+
+	// Calls specified functor with the stored arguments
+	template <typename TFunctor>
+	inline void Apply(TFunctor&& fnTarget)
+		{fnTarget(Get<tIdx>()...);}
+	template <typename TFunctor>
+	inline void Apply(TFunctor&& fnTarget) const
+		{fnTarget(Get<tIdx>()...);}
+
+	inline TupleType ToTuple() const
+		{return TupleType(Get<tIdx>()...);}
+};
+
+// Specialization for notifications without arguments
+template <>
+class TArgumentPackImpl<std::index_sequence<>>
+{
+public:
+	using TupleType = std::tuple<>;
+
+	template <typename TSender>
+	inline void Invoke(TConnection<> const& oCnctn, TSender* pSender)
+		{oCnctn.template Invoke<TSender>(pSender);}
+
+	template <typename TFunctor>
+	inline void Apply(TFunctor&& fnTarget) const
+		{fnTarget();}
+
+	inline TupleType ToTuple() const
+		{return TupleType();}
+};
+
+template <typename... TArguments>
+using TArgumentPack = TArgumentPackImpl<std::index_sequence_for<TArguments...>, TArguments...>;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -629,8 +1388,10 @@ public:
 	//
 	//	Constructors
 	//
-	inline TNotification() = default;
+	inline TNotification();
 	inline ~TNotification() = default;
+	inline TNotification(TNotification&&) = default;
+	inline TNotification& operator=(TNotification&&) = default;
 
 public:
 	//
@@ -644,7 +1405,13 @@ public:
 
 	// Emits the notification with the specified sender and arguments
 	template <typename TSender>
-	inline void Notify(TSender* pSender, TArguments... args) const;
+	inline void Notify(TSender* pSender, TArguments... args) const NCD_EMIT_NOEXCEPT;
+	// Calls fnProducer() and emits the arguments it returns only if any listener would run (see HasActiveListeners)
+	// or the notification is hooked (see CNotificationHook)
+	// Producer returns the argument value for single argument notifications, std::tuple of them otherwise
+	// Returns true if the notification was emitted
+	template <typename TSender, typename TProducer>
+	inline bool NotifyLazy(TSender* pSender, TProducer&& fnProducer) const;
 
 public:
 	//
@@ -654,7 +1421,22 @@ public:
 	inline TNotification& operator -= (ConnectionType const& oCnctn);
 
 	template <typename TSender>
-	inline void operator () (TSender* pSender, TArguments... args) const;
+	inline void operator () (TSender* pSender, TArguments... args) const NCD_EMIT_NOEXCEPT;
+
+protected:
+	// Installs the observer of the links and emissions (null removes it), hook should outlive the notification
+	inline void SetHook(TNotificationHook<TArguments...> const* pHook);
+
+private:
+	//
+	//	Implementation
+	//
+	template <typename TSender, typename TValue>
+	inline void EmitProduced(TSender* pSender, TValue&& tValue, std::true_type) const;
+	template <typename TSender, typename TTuple>
+	inline void EmitProduced(TSender* pSender, TTuple&& tArgs, std::false_type) const;
+	template <typename TSender, typename TTuple, size_t... tIdx>
+	inline void EmitUnpacked(TSender* pSender, TTuple& tArgs, std::index_sequence<tIdx...>) const;
 };
 
 //
@@ -667,18 +1449,27 @@ class TNotificationX : public TNotification<TArguments...>
 public:
 	inline TNotificationX();
 	inline ~TNotificationX() = default;
+	// Relocation, notification chains follow the new address
+	inline TNotificationX(TNotificationX&& other);
+	inline TNotificationX& operator=(TNotificationX&& other);
 
 	using NotificationType = TNotification<TArguments...>;
 	using ConnectionType = typename NotificationType::ConnectionType;
 
 
 	// Notify method - invokes all connections
-	inline void Notify(TSender* pSender, TArguments... args) const;
-	inline void operator() (TSender* pSender, TArguments... args) const;
+	inline void Notify(TSender* pSender, TArguments... args) const NCD_EMIT_NOEXCEPT;
+	inline void operator() (TSender* pSender, TArguments... args) const NCD_EMIT_NOEXCEPT;
+	// Produces arguments and emits only if any listener would run (see TNotification::NotifyLazy)
+	template <typename TProducer>
+	inline bool NotifyLazy(TSender* pSender, TProducer&& fnProducer) const;
+
+	// Returns lower bound of the heap memory held by the notification including its allocated chain connection
+	inline size_t MemoryUsage() const;
 
 	//	Notifaction to Notification connection
-	//	Embedded connection object to link Notifications with same sender & argument types 
-	ConnectionType cnt_Notify; // cnt - stands as abbreviation for the word 'connection'
+	//	Embedded connection object to link Notifications with same sender & argument types (allocated on demand)
+	TChainConnection<TArguments...> cnt_Notify; // cnt - stands as abbreviation for the word 'connection'
 };
 
 //
@@ -691,18 +1482,25 @@ class TNotificationEX final : public TNotificationX<TSender, TArguments...>
 public:
 	inline TNotificationEX(TSender& oSender);
 	inline ~TNotificationEX() = default;
+	// Relocation, notification embedded into its sender (at construction) follows it, otherwise keeps the sender
+	inline TNotificationEX(TNotificationEX&& other);
+	inline TNotificationEX& operator=(TNotificationEX&& other);
 
 	using Base = TNotificationX<TSender, TArguments...>;
 	using NotificationType = typename Base::NotificationType;
 	using ConnectionType = typename Base::ConnectionType;
 
 	// Notify method
-	inline void Notify(TArguments... args) const;
-	inline void operator() (TArguments... args) const;
+	inline void Notify(TArguments... args) const NCD_EMIT_NOEXCEPT;
+	inline void operator() (TArguments... args) const NCD_EMIT_NOEXCEPT;
+	// Produces arguments and emits only if any listener would run (see TNotification::NotifyLazy)
+	template <typename TProducer>
+	inline bool NotifyLazy(TProducer&& fnProducer) const;
 
 private:
-	// Own sender object
-	TSender& m_oSender;
+	// Own sender object and the position of the notification in it
+	TSender*		m_pSender;
+	COwnerOffset	m_oSender;
 };
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -754,6 +1552,9 @@ using Connection = TConnectionX<TCallable>;
 template <typename TCallable>
 using Connection2 = TConnectionX2<TCallable>;
 
+template <typename TCallable>
+using StaticConnection = TStaticConnection<TCallable>;
+
 //
 // NotificationBlocker definition for external use
 //
@@ -764,6 +1565,11 @@ using NotificationBlocker = CNotificationBase::CBlocker;
 //
 using ConnectionMuter = CConnectionBase::CMuter;
 
+//
+//	ConnectionGroup definition for external use
+//
+using ConnectionGroup = CConnectionGroup;
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -773,43 +1579,139 @@ using ConnectionMuter = CConnectionBase::CMuter;
 inline CNotificationBase::~CNotificationBase()
 {
 	RemoveAllConnections();
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	if (m_pTally != nullptr)
+	{
+		m_pTally->nObjects.fetch_sub(1, std::memory_order_relaxed);
+		m_pTally->nHeapBytes.fetch_sub(static_cast<int64_t>(m_nTalliedBytes), std::memory_order_relaxed);
+	}
+#endif
+}
+
+inline CNotificationBase::CNotificationBase(CNotificationBase&& other) :
+	m_blocked(other.m_blocked)
+{
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	if (other.m_pTally != nullptr)
+		AttachTally(*other.m_pTally);
+#endif
+	TakeConnections(other);
+}
+
+inline CNotificationBase& CNotificationBase::operator=(CNotificationBase&& other)
+{
+	if (this != &other)
+	{
+		RemoveAllConnections();
+		m_blocked = other.m_blocked;
+		TakeConnections(other);
+	}
+	return *this;
 }
 
 inline bool CNotificationBase::HasConnections() const
 {
-	return !m_aConnections.empty();
+	return (m_aConnections.size() > m_nHoles);
 }
 
-inline bool CNotificationBase::IsConnected(CConnectionBase const& oCnctn) const
+inline bool CNotificationBase::HasActiveListeners() const
 {
-	auto it = std::find(m_aConnections.begin(), m_aConnections.end(), &oCnctn);
-	return (it != m_aConnections.end());
+	return (!m_blocked && m_nActive > 0);
 }
 
-inline bool CNotificationBase::RemoveConnection(CConnectionBase const& oCnctn) const
+inline bool CNotificationBase::IsConnected(CConnectionBase const& oCnctn) const
 {
-	bool bRemoved = Remove(&oCnctn);
-	if (bRemoved && oCnctn.HasConnectedNotifications() && oCnctn.IsConnected(*this))
-		oCnctn.Disconnect(*this);
-	return bRemoved;
+	return oCnctn.IsConnected(*this);
 }
 
-inline void CNotificationBase::RemoveAllConnections() const
+template <typename TVisitor>
+inline void CNotificationBase::ForEachConnection(TVisitor&& fnVisitor) const
 {
-	auto aConnections = std::move(m_aConnections);
-	for (CConnectionBase const* pCnctn : aConnections)
+	for (CConnectionBase const* pCnctn : m_aConnections)
 	{
-		if (pCnctn->HasConnectedNotifications() && pCnctn->IsConnected(*this))
-			pCnctn->Disconnect(*this);
+		if (pCnctn != nullptr)
+			fnVisitor(*pCnctn);
 	}
 }
 
-inline bool CNotificationBase::IsBlocked() const
+inline bool CNotificationBase::RemoveConnection(CConnectionBase const& oCnctn) const
 {
-	return m_blocked;
+	return Unlink(oCnctn);
 }
 
-inline bool CNotificationBase::SetBlockedState(bool bNewState)
+inline void CNotificationBase::RemoveAllConnections() const
+{
+	m_nActive = 0;
+	m_nTracked = 0;
+	if (m_nEmitDepth > 0)
+	{
+		for (CConnectionBase const*& pCnctn : m_aConnections)
+		{
+			if (pCnctn != nullptr)
+			{
+				pCnctn->Remove(this);
+				pCnctn = nullptr;
+				++m_nHoles;
+			}
+		}
+	}
+	else
+	{
+		auto aConnections = std::move(m_aConnections);
+		m_aConnections.clear();
+		m_nHoles = 0;
+		Retally();
+		for (CConnectionBase const* pCnctn : aConnections)
+		{
+			if (pCnctn != nullptr)
+				pCnctn->Remove(this);
+		}
+	}
+}
+
+template <typename TIterator>
+inline void CNotificationBase::RemoveConnections(TIterator itFirst, TIterator itLast) const
+{
+	bool bAny = false;
+	for (TIterator it = itFirst; it != itLast; ++it)
+	{
+		CConnectionBase const* pCnctn = *it;
+		if (pCnctn->Remove(this))
+		{
+			pCnctn->m_bRetiring = true;
+			bAny = true;
+		}
+	}
+
+	if (bAny)
+	{
+		Compact();
+		for (TIterator it = itFirst; it != itLast; ++it)
+			(*it)->m_bRetiring = false;
+	}
+}
+
+inline size_t CNotificationBase::MemoryUsage() const
+{
+	return m_aConnections.capacity() * sizeof(CConnectionBase const*);
+}
+
+inline void CNotificationBase::ShrinkToFit() const
+{
+	if (m_nEmitDepth > 0)
+		return;
+	if (m_nHoles > 0)
+		EraseHoles();
+	if (m_aConnections.capacity() > m_aConnections.size())
+		Reallocate(m_aConnections.size());
+}
+
+inline bool CNotificationBase::IsBlocked() const
+{
+	return m_blocked;
+}
+
+inline bool CNotificationBase::SetBlockedState(bool bNewState)
 {
 	bool bOldState = m_blocked;
 	m_blocked = bNewState;
@@ -821,22 +1723,273 @@ inline CNotificationBase::CBlocker CNotificationBase::Block()
 	return std::move(CBlocker(*this));
 }
 
-inline void CNotificationBase::Add(CConnectionBase const* pCnctn) const
+inline void CNotificationBase::Link(CConnectionBase const& oCnctn, bool bMoveToEnd) const
+{
+	auto itLink = oCnctn.m_mapConnections.find(this);
+	bool const bNew = (itLink == oCnctn.m_mapConnections.end());
+	if (bNew)
+		itLink = oCnctn.m_mapConnections.emplace(this, 0).first;
+	else if (bMoveToEnd)
+		ReleaseSlot(itLink->second);
+	else
+		return;
+
+	itLink->second = m_aConnections.size();
+	m_aConnections.push_back(&oCnctn);
+	if (!oCnctn.m_bMuted)
+		++m_nActive;
+	if (oCnctn.IsTracked())
+		++m_nTracked;
+	Retally();
+	oCnctn.Retally();
+	if (bNew && m_pHook != nullptr)
+		m_pHook->OnLinked(oCnctn);
+}
+
+inline bool CNotificationBase::Unlink(CConnectionBase const& oCnctn) const
 {
-	Remove(pCnctn);
-	m_aConnections.push_back(pCnctn);
+	auto itLink = oCnctn.m_mapConnections.find(this);
+	if (itLink == oCnctn.m_mapConnections.end())
+		return false;
+	size_t const nIdx = itLink->second;
+	oCnctn.m_mapConnections.erase(itLink);
+	oCnctn.Retally();
+	ReleaseSlot(nIdx);
+	return true;
 }
 
-inline bool CNotificationBase::Remove(CConnectionBase const* pCnctn) const
+inline void CNotificationBase::ReleaseSlot(size_t nIdx) const
 {
-	bool bRemoved = false;
-	auto it = std::find(m_aConnections.begin(), m_aConnections.end(), pCnctn);
-	if (it != m_aConnections.end())
+	if (!m_aConnections[nIdx]->m_bMuted)
+		--m_nActive;
+	if (m_aConnections[nIdx]->IsTracked())
+		--m_nTracked;
+	if (m_nEmitDepth == 0 && nIdx + 1 == m_aConnections.size())
 	{
-		bRemoved = true;
-		m_aConnections.erase(it);
+		// Last connection goes away at once, along with the holes preceding it (capacity is kept)
+		m_aConnections.pop_back();
+		while (!m_aConnections.empty() && m_aConnections.back() == nullptr)
+		{
+			m_aConnections.pop_back();
+			--m_nHoles;
+		}
+		return;
 	}
-	return bRemoved;
+
+	m_aConnections[nIdx] = nullptr;
+	++m_nHoles;
+	// Erasing once the holes make up the half of the list keeps the cost of removals amortized constant
+	if (m_nEmitDepth == 0 && m_nHoles * 2 > m_aConnections.size())
+		EraseHoles();
+}
+
+inline void CNotificationBase::LinkConnection(CConnectionBase const& oCnctn) const
+{
+	assert(oCnctn.AcceptsLink(*this) && "Shot limited connection could be linked to a single notification");
+	if (!oCnctn.AcceptsLink(*this))
+		return;
+	Link(oCnctn, true);
+}
+
+inline void CNotificationBase::TakeConnections(CNotificationBase& other)
+{
+	m_aConnections.reserve(other.m_aConnections.size() - other.m_nHoles);
+	for (CConnectionBase const* pCnctn : other.m_aConnections)
+	{
+		if (pCnctn != nullptr)
+		{
+			pCnctn->ReplaceNotification(&other, this, m_aConnections.size());
+			m_aConnections.push_back(pCnctn);
+		}
+	}
+	m_nActive = other.m_nActive;
+	m_nTracked = other.m_nTracked;
+	other.m_aConnections.clear();
+	other.m_nHoles = 0;
+	other.m_nActive = 0;
+	other.m_nTracked = 0;
+	Retally();
+	other.Retally();
+}
+
+inline void CNotificationBase::ReplaceConnection(size_t nIdx, CConnectionBase const* pNew) const
+{
+	m_aConnections[nIdx] = pNew;
+}
+
+inline void CNotificationBase::Compact() const
+{
+	if (m_nEmitDepth > 0)
+	{
+		for (CConnectionBase const*& pCnctn : m_aConnections)
+		{
+			if (pCnctn != nullptr && pCnctn->m_bRetiring)
+			{
+				if (!pCnctn->m_bMuted)
+					--m_nActive;
+				if (pCnctn->IsTracked())
+					--m_nTracked;
+				pCnctn = nullptr;
+				++m_nHoles;
+			}
+		}
+	}
+	else
+	{
+		for (CConnectionBase const*& pCnctn : m_aConnections)
+		{
+			if (pCnctn != nullptr && pCnctn->m_bRetiring)
+			{
+				if (!pCnctn->m_bMuted)
+					--m_nActive;
+				if (pCnctn->IsTracked())
+					--m_nTracked;
+				pCnctn = nullptr;
+			}
+		}
+		EraseHoles();
+	}
+}
+
+inline void CNotificationBase::EraseHoles() const
+{
+	size_t nTo = 0;
+	for (CConnectionBase const* pCnctn : m_aConnections)
+	{
+		if (pCnctn == nullptr)
+			continue;
+		if (m_aConnections[nTo] != pCnctn)
+		{
+			m_aConnections[nTo] = pCnctn;
+			pCnctn->m_mapConnections.find(this)->second = nTo;
+		}
+		++nTo;
+	}
+	m_aConnections.resize(nTo);
+	m_nHoles = 0;
+	ApplyShrinkPolicy();
+}
+
+inline void CNotificationBase::ApplyShrinkPolicy() const
+{
+	size_t const nCapacity = m_aConnections.capacity();
+	if (nCapacity >= NCD_SHRINK_MIN_CAPACITY && m_aConnections.size() < nCapacity / 4)
+		Reallocate(m_aConnections.size() * 2);
+}
+
+inline void CNotificationBase::Reallocate(size_t nCapacity) const
+{
+	std::vector<CConnectionBase const*> aConnections;
+	aConnections.reserve((std::max)(nCapacity, m_aConnections.size()));
+	aConnections.assign(m_aConnections.begin(), m_aConnections.end());
+	m_aConnections.swap(aConnections);
+	Retally();
+}
+
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+inline void CNotificationBase::AttachTally(SMemoryTally& oTally)
+{
+	m_pTally = &oTally;
+	m_pTally->nObjects.fetch_add(1, std::memory_order_relaxed);
+	Retally();
+}
+#endif
+
+inline void CNotificationBase::Retally() const
+{
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	if (m_pTally == nullptr)
+		return;
+	size_t const nBytes = MemoryUsage();
+	if (nBytes != m_nTalliedBytes)
+	{
+		m_pTally->nHeapBytes.fetch_add(static_cast<int64_t>(nBytes) - static_cast<int64_t>(m_nTalliedBytes), std::memory_order_relaxed);
+		m_nTalliedBytes = nBytes;
+	}
+#endif
+}
+
+inline void CNotificationBase::ConsumeShot(size_t nIdx) const
+{
+	CConnectionBase const* pCnctn = m_aConnections[nIdx];
+	if (pCnctn->m_bMuted || --pCnctn->m_nShotsLeft != 0)
+		return;
+
+	// Last shot: unlink before invoking, so reentrant emissions would not invoke it again
+	// Limited connection is linked only to this notification, so it is disconnected completely
+	// Connection is counted as tracked for the shots it had
+	m_aConnections[nIdx] = nullptr;
+	++m_nHoles;
+	--m_nActive;
+	--m_nTracked;
+	pCnctn->Remove(this);
+}
+
+inline CNotificationBase::SEpoch& CNotificationBase::ThreadEpoch()
+{
+	static thread_local SEpoch s_oEpoch;
+	return s_oEpoch;
+}
+
+inline void CNotificationBase::EndCascade(SEpoch& oEpoch)
+{
+	// Hooks run one by one, any of them could emit (nested cascade drains the rest of the queue) or cancel others
+	while (oEpoch.nDepth == 0 && oEpoch.pFirstHook != nullptr)
+	{
+		CCascadeHook* pHook = oEpoch.pFirstHook;
+		oEpoch.pFirstHook = pHook->m_pNextHook;
+		if (oEpoch.pFirstHook == nullptr)
+			oEpoch.pLastHook = nullptr;
+		pHook->m_pNextHook = nullptr;
+		pHook->m_bScheduled = false;
+		pHook->OnCascadeEnd();
+	}
+}
+
+inline void CNotificationBase::TakeEpochBlock(SEpoch& oEpoch)
+{
+	static std::atomic<uint64_t> s_nNextBlock {0};
+	uint64_t const nFirst = s_nNextBlock.fetch_add(c_nEpochBlock, std::memory_order_relaxed);
+	// Zero epoch is never current, so connections not invoked yet are not skipped
+	oEpoch.nCurrent = (nFirst == 0) ? 1 : nFirst;
+	oEpoch.nBlockEnd = nFirst + c_nEpochBlock;
+}
+
+inline bool CNotificationBase::EnterEpoch(SEpoch const& oEpoch, CConnectionBase const& oCnctn)
+{
+	if (oCnctn.m_nEpoch == oEpoch.nCurrent)
+		return false;
+	oCnctn.m_nEpoch = oEpoch.nCurrent;
+	return true;
+}
+
+//
+//	CEmitScope
+//
+inline CNotificationBase::CEmitScope::CEmitScope(CNotificationBase const& oNtfctn)
+	: m_oNtfctn(oNtfctn), m_pEpoch((oNtfctn.m_nTracked > 0) ? &ThreadEpoch() : nullptr)
+{
+	++m_oNtfctn.m_nEmitDepth;
+	if (m_pEpoch != nullptr && m_pEpoch->nDepth++ == 0 && ++m_pEpoch->nCurrent == m_pEpoch->nBlockEnd)
+		TakeEpochBlock(*m_pEpoch);
+}
+
+inline CNotificationBase::CEmitScope::~CEmitScope()
+{
+	if (m_pEpoch != nullptr)
+		--m_pEpoch->nDepth;
+	if (--m_oNtfctn.m_nEmitDepth == 0 && m_oNtfctn.m_nHoles > 0)
+		m_oNtfctn.EraseHoles();
+}
+
+inline CNotificationBase::SEpoch* CNotificationBase::CEmitScope::GetEpoch() const
+{
+	return m_pEpoch;
+}
+
+inline CNotificationBase::SEpoch* CNotificationBase::CEmitScope::GetCascade() const
+{
+	return (m_pEpoch != nullptr && m_pEpoch->nDepth == 1) ? m_pEpoch : nullptr;
 }
 
 //
@@ -876,35 +2029,100 @@ inline void CNotificationBase::CBlocker::Release()
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 inline CConnectionBase::~CConnectionBase()
 {
+#if !defined(NDEBUG)
+	assert(m_nGroups == 0 && "Connection should be removed from its groups before it is destroyed");
+#endif
 	DisconnectAll();
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	if (m_pTally != nullptr)
+	{
+		m_pTally->nObjects.fetch_sub(1, std::memory_order_relaxed);
+		m_pTally->nHeapBytes.fetch_sub(static_cast<int64_t>(m_nTalliedBytes), std::memory_order_relaxed);
+	}
+#endif
+}
+
+inline CConnectionBase::CConnectionBase(CConnectionBase&& other) :
+	m_bMuted(other.m_bMuted), m_bDedup(other.m_bDedup), m_bCascade(other.m_bCascade), m_nShotsLeft(other.m_nShotsLeft),
+	m_nEpoch(other.m_nEpoch)
+{
+#if !defined(NDEBUG)
+	assert(other.m_nGroups == 0 && "Connection should be removed from its groups before it is moved");
+#endif
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	if (other.m_pTally != nullptr)
+		AttachTally(*other.m_pTally);
+#endif
+	TakeNotifications(other);
+}
+
+inline CConnectionBase& CConnectionBase::operator=(CConnectionBase&& other)
+{
+	if (this != &other)
+	{
+#if !defined(NDEBUG)
+		assert(other.m_nGroups == 0 && "Connection should be removed from its groups before it is moved");
+#endif
+		DisconnectAll();
+		m_bMuted = other.m_bMuted;
+		m_bDedup = other.m_bDedup;
+		m_bCascade = other.m_bCascade;
+		m_nShotsLeft = other.m_nShotsLeft;
+		m_nEpoch = other.m_nEpoch;
+		TakeNotifications(other);
+	}
+	return *this;
 }
 
 inline bool CConnectionBase::HasConnectedNotifications() const
 {
-	return !m_setConnections.empty();
+	return !m_mapConnections.empty();
 }
 
 inline bool CConnectionBase::IsConnected(CNotificationBase const& oNtfctn) const
 {
-	return (m_setConnections.count(&oNtfctn) > 0);
+	return (m_mapConnections.count(&oNtfctn) > 0);
+}
+
+template <typename TVisitor>
+inline void CConnectionBase::ForEachNotification(TVisitor&& fnVisitor) const
+{
+	for (auto const& oLink : m_mapConnections)
+		fnVisitor(*oLink.first);
+}
+
+inline CNotificationBase const* CConnectionBase::GetForwardTarget() const
+{
+	return m_bForward ? ForwardTargetSlot() : nullptr;
+}
+
+inline size_t CConnectionBase::MemoryUsage() const
+{
+	// Every library keeps at least a pointer per bucket and the value per node (single bucket could be embedded)
+	using NodeValue = std::pair<CNotificationBase const* const, size_t>;
+	size_t const nBuckets = m_mapConnections.bucket_count();
+	return ((nBuckets > 1) ? nBuckets * sizeof(void*) : 0) + m_mapConnections.size() * sizeof(NodeValue);
+}
+
+inline void CConnectionBase::ShrinkToFit() const
+{
+	m_mapConnections.rehash(0);
+	Retally();
 }
 
 inline bool CConnectionBase::Disconnect(CNotificationBase const& oNtfctn) const
 {
-	bool bRemoved = Remove(&oNtfctn);
-	if (bRemoved && oNtfctn.HasConnections() && oNtfctn.IsConnected(*this))
-		oNtfctn.RemoveConnection(*this);
-	return bRemoved;
+	return oNtfctn.Unlink(*this);
 }
 
 inline void CConnectionBase::DisconnectAll() const
 {
-	auto aCnctns = std::move(m_setConnections);
-	for (CNotificationBase const* pNtfctn : aCnctns)
-	{
-		if (pNtfctn->HasConnections() && pNtfctn->IsConnected(*this))
-			pNtfctn->RemoveConnection(*this);
-	}
+	// Every notification releases the slot at the recorded position, no searching
+	auto mapCnctns = std::move(m_mapConnections);
+	m_mapConnections.clear();
+	Retally();
+	for (auto const& oLink : mapCnctns)
+		oLink.first->ReleaseSlot(oLink.second);
 }
 
 inline bool CConnectionBase::IsMuted() const
@@ -916,22 +2134,158 @@ inline bool CConnectionBase::SetMuteState(bool bMute)
 {
 	bool bPrevMuted = m_bMuted;
 	m_bMuted = bMute;
+	if (bPrevMuted != bMute)
+	{
+		// Keep active listener counts of the connected notifications in line
+		for (auto const& oLink : m_mapConnections)
+		{
+			if (bMute)
+				--oLink.first->m_nActive;
+			else
+				++oLink.first->m_nActive;
+		}
+	}
 	return bPrevMuted;
 }
 
+inline bool CConnectionBase::SetShotLimit(uint32_t nShots)
+{
+	if (nShots != 0 && m_mapConnections.size() > 1)
+		return false;
+	bool const bWasTracked = IsTracked();
+	m_nShotsLeft = nShots;
+	UpdateTracked(bWasTracked);
+	return true;
+}
+
+inline uint32_t CConnectionBase::GetShotsLeft() const
+{
+	return m_nShotsLeft;
+}
+
+inline void CConnectionBase::SetDeduplicated(bool bDedup)
+{
+	bool const bWasTracked = IsTracked();
+	m_bDedup = bDedup;
+	UpdateTracked(bWasTracked);
+}
+
+inline bool CConnectionBase::IsDeduplicated() const
+{
+	return m_bDedup;
+}
+
+inline void CConnectionBase::SetCascadeListener(bool bCascade)
+{
+	bool const bWasTracked = IsTracked();
+	m_bCascade = bCascade;
+	UpdateTracked(bWasTracked);
+}
+
+inline bool CConnectionBase::IsCascadeListener() const
+{
+	return m_bCascade;
+}
+
+inline bool CConnectionBase::IsTracked() const
+{
+	return (m_bDedup || m_bCascade || m_bForward || m_nShotsLeft != 0);
+}
+
+inline void CConnectionBase::UpdateTracked(bool bWasTracked) const
+{
+	bool const bTracked = IsTracked();
+	if (bTracked == bWasTracked)
+		return;
+	for (auto const& oLink : m_mapConnections)
+	{
+		if (bTracked)
+			++oLink.first->m_nTracked;
+		else
+			--oLink.first->m_nTracked;
+	}
+}
+
 inline CConnectionBase::CMuter CConnectionBase::Mute()
 {
 	return std::move(CMuter(*this));
 }
 
-inline void CConnectionBase::Add(CNotificationBase const* pNtfctn) const
+inline bool CConnectionBase::Remove(CNotificationBase const* pNtfctn) const
 {
-	m_setConnections.insert(pNtfctn);
+	if (m_mapConnections.erase(pNtfctn) == 0)
+		return false;
+	Retally();
+	return true;
 }
 
-inline bool CConnectionBase::Remove(CNotificationBase const* pNtfctn) const
+inline void CConnectionBase::TakeNotifications(CConnectionBase& other)
+{
+	m_mapConnections = std::move(other.m_mapConnections);
+	other.m_mapConnections.clear();
+	for (auto const& oLink : m_mapConnections)
+		oLink.first->ReplaceConnection(oLink.second, this);
+	Retally();
+	other.Retally();
+}
+
+inline void CConnectionBase::ReplaceNotification(CNotificationBase const* pOld, CNotificationBase const* pNew, size_t nIdx) const
+{
+#if defined(__cpp_lib_node_extract)
+	// Node is reused, so relocation does not allocate
+	auto oNode = m_mapConnections.extract(pOld);
+	if (!oNode.empty())
+	{
+		oNode.key() = pNew;
+		oNode.mapped() = nIdx;
+		m_mapConnections.insert(std::move(oNode));
+	}
+#else
+	if (m_mapConnections.erase(pOld) > 0)
+		m_mapConnections.emplace(pNew, nIdx);
+#endif
+}
+
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+inline void CConnectionBase::AttachTally(SMemoryTally& oTally)
 {
-	return (m_setConnections.erase(pNtfctn) > 0);
+	m_pTally = &oTally;
+	m_pTally->nObjects.fetch_add(1, std::memory_order_relaxed);
+	Retally();
+}
+#endif
+
+inline void CConnectionBase::Retally() const
+{
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	if (m_pTally == nullptr)
+		return;
+	size_t const nBytes = MemoryUsage();
+	if (nBytes != m_nTalliedBytes)
+	{
+		m_pTally->nHeapBytes.fetch_add(static_cast<int64_t>(nBytes) - static_cast<int64_t>(m_nTalliedBytes), std::memory_order_relaxed);
+		m_nTalliedBytes = nBytes;
+	}
+#endif
+}
+
+inline void CConnectionBase::LinkNotification(CNotificationBase const& oNtfctn) const
+{
+	assert(AcceptsLink(oNtfctn) && "Shot limited connection could be linked to a single notification");
+	if (!AcceptsLink(oNtfctn))
+		return;
+	oNtfctn.Link(*this, false);
+}
+
+inline bool CConnectionBase::AcceptsLink(CNotificationBase const& oNtfctn) const
+{
+	return (m_nShotsLeft == 0 || m_mapConnections.empty() || IsConnected(oNtfctn));
+}
+
+inline CNotificationBase const*& CConnectionBase::ForwardTargetSlot() const
+{
+	char* pThis = reinterpret_cast<char*>(const_cast<CConnectionBase*>(this));
+	return *reinterpret_cast<CNotificationBase const**>(pThis - c_nForwardHeaderSize);
 }
 
 //
@@ -963,21 +2317,255 @@ inline void CConnectionBase::CMuter::Release()
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CConnectionGroup Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline CConnectionGroup::~CConnectionGroup()
+{
+	DisconnectAll();
+}
+
+inline bool CConnectionGroup::IsEmpty() const
+{
+	return m_setConnections.empty();
+}
+
+inline size_t CConnectionGroup::GetSize() const
+{
+	return m_setConnections.size();
+}
+
+inline void CConnectionGroup::Add(CConnectionBase const& oCnctn)
+{
+	bool const bAdded = m_setConnections.insert(&oCnctn).second;
+#if !defined(NDEBUG)
+	if (bAdded)
+		++oCnctn.m_nGroups;
+#endif
+	(void) bAdded;
+}
+
+inline bool CConnectionGroup::Remove(CConnectionBase const& oCnctn)
+{
+	if (m_setConnections.erase(&oCnctn) == 0)
+		return false;
+#if !defined(NDEBUG)
+	--oCnctn.m_nGroups;
+#endif
+	return true;
+}
+
+inline void CConnectionGroup::Clear()
+{
+#if !defined(NDEBUG)
+	for (CConnectionBase const* pCnctn : m_setConnections)
+		--pCnctn->m_nGroups;
+#endif
+	m_setConnections.clear();
+}
+
+inline void CConnectionGroup::DisconnectAll()
+{
+	auto aCnctns = std::move(m_setConnections);
+	m_setConnections.clear();
+
+	// Mark connections and collect affected notifications (each one only once)
+	std::vector<CNotificationBase const*> aNtfctns;
+	for (CConnectionBase const* pCnctn : aCnctns)
+	{
+#if !defined(NDEBUG)
+		--pCnctn->m_nGroups;
+#endif
+		pCnctn->m_bRetiring = true;
+		for (auto const& oLink : pCnctn->m_mapConnections)
+		{
+			CNotificationBase const* pNtfctn = oLink.first;
+			if (!pNtfctn->m_bCompactPending)
+			{
+				pNtfctn->m_bCompactPending = true;
+				aNtfctns.push_back(pNtfctn);
+			}
+		}
+		pCnctn->m_mapConnections.clear();
+		pCnctn->Retally();
+	}
+
+	// Single compaction pass per notification
+	for (CNotificationBase const* pNtfctn : aNtfctns)
+	{
+		pNtfctn->Compact();
+		pNtfctn->m_bCompactPending = false;
+	}
+
+	for (CConnectionBase const* pCnctn : aCnctns)
+		pCnctn->m_bRetiring = false;
+}
+
+inline CConnectionGroup& CConnectionGroup::operator += (CConnectionBase const& oCnctn)
+{
+	Add(oCnctn);
+	return *this;
+}
+
+inline CConnectionGroup& CConnectionGroup::operator -= (CConnectionBase const& oCnctn)
+{
+	Remove(oCnctn);
+	return *this;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Emission error sink Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline std::atomic<FnEmissionErrorSink>& EmissionErrorSinkRef()
+{
+	static std::atomic<FnEmissionErrorSink> s_fnSink {nullptr};
+	return s_fnSink;
+}
+
+inline FnEmissionErrorSink SetEmissionErrorSink(FnEmissionErrorSink fnSink)
+{
+	return EmissionErrorSinkRef().exchange(fnSink);
+}
+
+inline void ReportEmissionError(std::exception_ptr pError, CNotificationBase const& oNtfctn, CConnectionBase const& oCnctn)
+{
+	FnEmissionErrorSink fnSink = EmissionErrorSinkRef().load(std::memory_order_acquire);
+	if (fnSink != nullptr)
+		fnSink(pError, oNtfctn, oCnctn);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CCascadeHook Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline CCascadeHook::~CCascadeHook()
+{
+	Cancel();
+}
+
+inline bool CCascadeHook::Schedule()
+{
+	CNotificationBase::SEpoch& oEpoch = CNotificationBase::ThreadEpoch();
+	if (oEpoch.nDepth == 0)
+		return false;
+	if (m_bScheduled)
+		return true;
+
+	if (oEpoch.pLastHook != nullptr)
+		oEpoch.pLastHook->m_pNextHook = this;
+	else
+		oEpoch.pFirstHook = this;
+	oEpoch.pLastHook = this;
+	m_bScheduled = true;
+	return true;
+}
+
+inline void CCascadeHook::Cancel()
+{
+	if (!m_bScheduled)
+		return;
+
+	CNotificationBase::SEpoch& oEpoch = CNotificationBase::ThreadEpoch();
+	CCascadeHook* pPrev = nullptr;
+	for (CCascadeHook* pHook = oEpoch.pFirstHook; pHook != nullptr; pPrev = pHook, pHook = pHook->m_pNextHook)
+	{
+		if (pHook != this)
+			continue;
+		if (pPrev != nullptr)
+			pPrev->m_pNextHook = m_pNextHook;
+		else
+			oEpoch.pFirstHook = m_pNextHook;
+		if (oEpoch.pLastHook == this)
+			oEpoch.pLastHook = pPrev;
+		break;
+	}
+	m_pNextHook = nullptr;
+	m_bScheduled = false;
+}
+
+inline bool CCascadeHook::IsScheduled() const
+{
+	return m_bScheduled;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	SMemoryTally Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline std::atomic<SMemoryTally*>& MemoryTallyListRef()
+{
+	static std::atomic<SMemoryTally*> s_pFirst {nullptr};
+	return s_pFirst;
+}
+
+inline SMemoryTally::SMemoryTally(char const* szSignature, size_t nObjectSize) :
+	szSignature(szSignature), nObjectSize(nObjectSize)
+{
+	// Tallies are only prepended, so the visitors could walk the list without locking
+	std::atomic<SMemoryTally*>& pFirst = MemoryTallyListRef();
+	pNext = pFirst.load(std::memory_order_relaxed);
+	while (!pFirst.compare_exchange_weak(pNext, this, std::memory_order_release, std::memory_order_relaxed))
+		;
+}
+
+inline int64_t SMemoryTally::GetTotalBytes() const
+{
+	return nObjects.load(std::memory_order_relaxed) * static_cast<int64_t>(nObjectSize) + nHeapBytes.load(std::memory_order_relaxed);
+}
+
+template <typename TObject>
+inline SMemoryTally& MemoryTallyOf()
+{
+	static SMemoryTally s_oTally(NCD_FUNCTION_SIGNATURE, sizeof(TObject));
+	return s_oTally;
+}
+
+template <typename TVisitor>
+inline void ForEachMemoryTally(TVisitor&& fnVisitor)
+{
+	for (SMemoryTally const* pTally = MemoryTallyListRef().load(std::memory_order_acquire); pTally != nullptr; pTally = pTally->pNext)
+		fnVisitor(*pTally);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 //	TConnection Implementation
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename... TArguments>
+inline TConnection<TArguments...>::TConnection()
+{
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	AttachTally(MemoryTallyOf<TConnection>());
+#endif
+}
+
 template <typename... TArguments>
 inline TConnection<TArguments...>::TConnection(DelegateType oDelegate) :
 	m_oDelegate(oDelegate)
 {
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	AttachTally(MemoryTallyOf<TConnection>());
+#endif
 }
 
 template <typename... TArguments>
 inline TConnection<TArguments...>::TConnection(NotificationType const& oNtfctn, DelegateType oDelegate) :
 	m_oDelegate(oDelegate)
 {
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	AttachTally(MemoryTallyOf<TConnection>());
+#endif
 	Connect(oNtfctn);
 }
 
@@ -998,18 +2586,47 @@ inline void TConnection<TArguments...>::Init(NotificationType const& oNtfctn, De
 template <typename... TArguments>
 inline void TConnection<TArguments...>::Connect(NotificationType const& oNtfctn) const
 {
-	//ASSERT(!m_oDelegate.IsNull(), "Connection object should be initialized first then linied.");
-	Add(&oNtfctn);
-	if (!oNtfctn.IsConnected(*this))
-		oNtfctn.AddConnection(*this);
+	//ASSERT(!m_oDelegate.IsNull(), "Connection object should be initialized first then linied.");
+	LinkNotification(oNtfctn);
+}
+
+template <typename... TArguments>
+inline bool TConnection<TArguments...>::ConnectOnce(NotificationType const& oNtfctn)
+{
+	return ConnectShots(oNtfctn, 1);
+}
+
+template <typename... TArguments>
+inline bool TConnection<TArguments...>::ConnectShots(NotificationType const& oNtfctn, uint32_t nShots)
+{
+	if (HasConnectedNotifications() && !(m_mapConnections.size() == 1 && IsConnected(oNtfctn)))
+		return false;
+	SetShotLimit(nShots);
+	Connect(oNtfctn);
+	return true;
+}
+
+template <typename... TArguments>
+template <typename TSender>
+inline void TConnection<TArguments...>::Invoke(TSender* pSender, TArguments... args) const NCD_EMIT_NOEXCEPT
+{
+	if (!m_bMuted && !m_oDelegate.IsNull())
+	{
+		NCD_PROBE_INVOKE(this, m_oDelegate.GetStub(), m_oDelegate.GetTarget());
+		m_oDelegate(pSender, args...);
+	}
+}
+
+template <typename... TArguments>
+inline typename TConnection<TArguments...>::DelegateType const& TConnection<TArguments...>::GetDelegate() const
+{
+	return m_oDelegate;
 }
 
 template <typename... TArguments>
-template <typename TSender>
-inline void TConnection<TArguments...>::Invoke(TSender* pSender, TArguments... args) const
+inline void TConnection<TArguments...>::RebindTarget(void const* pOldTarget, void const* pNewTarget)
 {
-	if (!m_bMuted && !m_oDelegate.IsNull())
-		m_oDelegate(pSender, args...);
+	m_oDelegate.Rebind(pOldTarget, pNewTarget);
 }
 
 //
@@ -1028,19 +2645,36 @@ public:
 
 	//	Constructors
 	inline TConnectionX() = default;
+	// Relocation, connection embedded into its receiver (at Init) follows it, otherwise keeps the receiver
+	inline TConnectionX(TConnectionX&& other) :
+		ConnectionType(std::move(other)), m_oOwner(other.m_oOwner)
+		{ConnectionType::RebindTarget(m_oOwner.GetOwner(&other), m_oOwner.GetOwner(this));}
+	inline TConnectionX& operator=(TConnectionX&& other)
+	{
+		ConnectionType::operator=(std::move(other));
+		m_oOwner = other.m_oOwner;
+		ConnectionType::RebindTarget(m_oOwner.GetOwner(&other), m_oOwner.GetOwner(this));
+		return *this;
+	}
 
 	// Initializers
 	template <void(TReceiver::*TMethod)(TArguments...)>
 	inline void Init(TReceiver& oTargetObject)
 	{
+		m_oOwner.Capture(this, &oTargetObject, sizeof(TReceiver));
 		ConnectionType::Init(DelegateType::template Create<TReceiver, TMethod>(oTargetObject));
 	}
 
 	template <void(TReceiver::*TMethod)(TArguments...)>
 	inline void Init(NotificationType const& oNtfctn, TReceiver& oTargetObject)
 	{
+		m_oOwner.Capture(this, &oTargetObject, sizeof(TReceiver));
 		ConnectionType::Init(oNtfctn, DelegateType::template Create<TReceiver, TMethod>(oTargetObject));
 	}
+
+private:
+	// Position of the connection in its receiver
+	COwnerOffset	m_oOwner;
 };
 
 // Connection specialization for class member const functions (2)
@@ -1055,19 +2689,36 @@ public:
 
 	//	Constructors
 	inline TConnectionX() = default;
+	// Relocation, connection embedded into its receiver (at Init) follows it, otherwise keeps the receiver
+	inline TConnectionX(TConnectionX&& other) :
+		ConnectionType(std::move(other)), m_oOwner(other.m_oOwner)
+		{ConnectionType::RebindTarget(m_oOwner.GetOwner(&other), m_oOwner.GetOwner(this));}
+	inline TConnectionX& operator=(TConnectionX&& other)
+	{
+		ConnectionType::operator=(std::move(other));
+		m_oOwner = other.m_oOwner;
+		ConnectionType::RebindTarget(m_oOwner.GetOwner(&other), m_oOwner.GetOwner(this));
+		return *this;
+	}
 
 	// Initializers
 	template <void(TReceiver::*TMethod)(TArguments...) const>
 	inline void Init(TReceiver& oTargetObject)
 	{
+		m_oOwner.Capture(this, &oTargetObject, sizeof(TReceiver));
 		ConnectionType::Init(DelegateType::template Create<TReceiver, TMethod>(oTargetObject));
 	}
 
 	template <void(TReceiver::*TMethod)(TArguments...) const>
 	inline void Init(NotificationType const& oNtfctn, TReceiver& oTargetObject)
 	{
+		m_oOwner.Capture(this, &oTargetObject, sizeof(TReceiver));
 		ConnectionType::Init(oNtfctn, DelegateType::template Create<TReceiver, TMethod>(oTargetObject));
 	}
+
+private:
+	// Position of the connection in its receiver
+	COwnerOffset	m_oOwner;
 };
 
 // Connection specialization for static functions (3)
@@ -1113,19 +2764,36 @@ public:
 
 	//	Constructors
 	inline TConnectionX2() = default;
+	// Relocation, connection embedded into its receiver (at Init) follows it, otherwise keeps the receiver
+	inline TConnectionX2(TConnectionX2&& other) :
+		ConnectionType(std::move(other)), m_oOwner(other.m_oOwner)
+		{ConnectionType::RebindTarget(m_oOwner.GetOwner(&other), m_oOwner.GetOwner(this));}
+	inline TConnectionX2& operator=(TConnectionX2&& other)
+	{
+		ConnectionType::operator=(std::move(other));
+		m_oOwner = other.m_oOwner;
+		ConnectionType::RebindTarget(m_oOwner.GetOwner(&other), m_oOwner.GetOwner(this));
+		return *this;
+	}
 
 	// Initializers
 	template <void(TReceiver::*TMethod)(TSender*, TArguments...)>
 	inline void Init(TReceiver& oTargetObject)
 	{
+		m_oOwner.Capture(this, &oTargetObject, sizeof(TReceiver));
 		ConnectionType::Init(DelegateType::template CreateEx<TSender, TReceiver, TMethod>(oTargetObject));
 	}
 
 	template <void(TReceiver::*TMethod)(TSender*, TArguments...)>
 	inline void Init(NotificationType const& oNtfctn, TReceiver& oTargetObject)
 	{
+		m_oOwner.Capture(this, &oTargetObject, sizeof(TReceiver));
 		ConnectionType::Init(oNtfctn, DelegateType::template CreateEx<TSender, TReceiver, TMethod>(oTargetObject));
 	}
+
+private:
+	// Position of the connection in its receiver
+	COwnerOffset	m_oOwner;
 };
 
 // Connection specialization for class const member functions with Sender (5)
@@ -1140,19 +2808,36 @@ public:
 
 	//	Constructors
 	inline TConnectionX2() = default;
+	// Relocation, connection embedded into its receiver (at Init) follows it, otherwise keeps the receiver
+	inline TConnectionX2(TConnectionX2&& other) :
+		ConnectionType(std::move(other)), m_oOwner(other.m_oOwner)
+		{ConnectionType::RebindTarget(m_oOwner.GetOwner(&other), m_oOwner.GetOwner(this));}
+	inline TConnectionX2& operator=(TConnectionX2&& other)
+	{
+		ConnectionType::operator=(std::move(other));
+		m_oOwner = other.m_oOwner;
+		ConnectionType::RebindTarget(m_oOwner.GetOwner(&other), m_oOwner.GetOwner(this));
+		return *this;
+	}
 
 	// Initializers
 	template <void(TReceiver::*TMethod)(TSender*, TArguments...) const>
 	inline void Init(TReceiver& oTargetObject)
 	{
+		m_oOwner.Capture(this, &oTargetObject, sizeof(TReceiver));
 		ConnectionType::Init(DelegateType::template CreateEx<TSender, TReceiver, TMethod>(oTargetObject));
 	}
 
 	template <void(TReceiver::*TMethod)(TSender*, TArguments...) const>
 	inline void Init(NotificationType const& oNtfctn, TReceiver& oTargetObject)
 	{
+		m_oOwner.Capture(this, &oTargetObject, sizeof(TReceiver));
 		ConnectionType::Init(oNtfctn, DelegateType::template CreateEx<TSender, TReceiver, TMethod>(oTargetObject));
 	}
+
+private:
+	// Position of the connection in its receiver
+	COwnerOffset	m_oOwner;
 };
 
 // Connection specialization for static functions with Sender (6)
@@ -1183,33 +2868,395 @@ public:
 };
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TStaticConnection Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename... TArguments>
+template <void(*TFunction)(TArguments...)>
+inline void TStaticConnection<void(*)(TArguments...)>::Init()
+{
+	DelegateType const oDelegate = DelegateType::template Create<TFunction>();
+	if (!Construct(oDelegate))
+		Get().Init(oDelegate);
+}
+
+template <typename... TArguments>
+template <void(*TFunction)(TArguments...)>
+inline void TStaticConnection<void(*)(TArguments...)>::Init(NotificationType const& oNtfctn)
+{
+	DelegateType const oDelegate = DelegateType::template Create<TFunction>();
+	if (Construct(oDelegate))
+		Get().Connect(oNtfctn);
+	else
+		Get().Init(oNtfctn, oDelegate);
+}
+
+template <typename... TArguments>
+inline typename TStaticConnection<void(*)(TArguments...)>::ConnectionType&
+TStaticConnection<void(*)(TArguments...)>::Get() const
+{
+	if (!m_bConstructed.load(std::memory_order_acquire))
+		Construct(m_oDelegate);
+	return *reinterpret_cast<ConnectionType*>(m_aStorage);
+}
+
+template <typename... TArguments>
+inline TStaticConnection<void(*)(TArguments...)>::operator ConnectionType const& () const
+{
+	return Get();
+}
+
+template <typename... TArguments>
+inline bool TStaticConnection<void(*)(TArguments...)>::IsConstructed() const
+{
+	return m_bConstructed.load(std::memory_order_acquire);
+}
+
+template <typename... TArguments>
+inline void TStaticConnection<void(*)(TArguments...)>::Connect(NotificationType const& oNtfctn) const
+{
+	Get().Connect(oNtfctn);
+}
+
+template <typename... TArguments>
+inline bool TStaticConnection<void(*)(TArguments...)>::Disconnect(CNotificationBase const& oNtfctn) const
+{
+	return IsConstructed() && Get().Disconnect(oNtfctn);
+}
+
+template <typename... TArguments>
+inline void TStaticConnection<void(*)(TArguments...)>::DisconnectAll() const
+{
+	if (IsConstructed())
+		Get().DisconnectAll();
+}
+
+template <typename... TArguments>
+inline bool TStaticConnection<void(*)(TArguments...)>::Construct(DelegateType const& oDelegate) const
+{
+	static_assert(std::is_trivially_destructible<std::once_flag>::value, "Static connection should stay trivially destructible");
+	bool bConstructed = false;
+	std::call_once(m_oConstruct, [this, &oDelegate, &bConstructed]()
+	{
+		new (m_aStorage) ConnectionType(oDelegate);
+		m_bConstructed.store(true, std::memory_order_release);
+		bConstructed = true;
+	});
+	return bConstructed;
+}
+
+template <typename... TStaticCnctns>
+inline void ConstructStaticConnections(TStaticCnctns const&... oCnctns)
+{
+	int aDummy[] = {0, (oCnctns.Get(), 0)...};
+	(void) aDummy;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TChainConnection Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename... TArguments>
+inline TChainConnection<TArguments...>::~TChainConnection()
+{
+	Free();
+}
+
+template <typename... TArguments>
+inline TChainConnection<TArguments...>::TChainConnection(TChainConnection&& other) :
+	m_oDelegate(other.m_oDelegate), m_pOwner(other.m_pOwner), m_pCnctn(other.m_pCnctn)
+{
+	other.m_pCnctn = nullptr;
+}
+
+template <typename... TArguments>
+inline TChainConnection<TArguments...>& TChainConnection<TArguments...>::operator=(TChainConnection&& other)
+{
+	if (this != &other)
+	{
+		Free();
+		m_oDelegate = other.m_oDelegate;
+		m_pOwner = other.m_pOwner;
+		m_pCnctn = other.m_pCnctn;
+		other.m_pCnctn = nullptr;
+	}
+	return *this;
+}
+
+template <typename... TArguments>
+inline void TChainConnection<TArguments...>::Init(DelegateType const& oDelegate)
+{
+	m_oDelegate = oDelegate;
+	if (m_pCnctn != nullptr)
+		m_pCnctn->Init(oDelegate);
+}
+
+template <typename... TArguments>
+inline void TChainConnection<TArguments...>::Init(NotificationType const& oNtfctn, DelegateType const& oDelegate)
+{
+	Init(oDelegate);
+	Get().Connect(oNtfctn);
+}
+
+template <typename... TArguments>
+inline typename TChainConnection<TArguments...>::ConnectionType& TChainConnection<TArguments...>::Get() const
+{
+	// Block keeps the forward target in front of the connection, so connections do not need a pointer for it.
+	// The header is found from the CConnectionBase address, which has to be the address of the connection itself
+	static_assert(sizeof(CNotificationBase const*) <= CConnectionBase::c_nForwardHeaderSize &&
+				  alignof(ConnectionType) <= CConnectionBase::c_nForwardHeaderSize,
+				  "Forward target header should keep the connection aligned");
+	static_assert(std::is_base_of<CConnectionBase, ConnectionType>::value &&
+				  !std::is_polymorphic<CConnectionBase>::value && !std::is_polymorphic<ConnectionType>::value,
+				  "CConnectionBase should be the leading subobject of the chaining connection");
+	if (m_pCnctn == nullptr)
+	{
+		char* pBlock = static_cast<char*>(::operator new(CConnectionBase::c_nForwardHeaderSize + sizeof(ConnectionType)));
+		m_pCnctn = new (pBlock + CConnectionBase::c_nForwardHeaderSize) ConnectionType(m_oDelegate);
+		assert(static_cast<void*>(static_cast<CConnectionBase*>(m_pCnctn)) == pBlock + CConnectionBase::c_nForwardHeaderSize);
+		m_pCnctn->m_bForward = true;
+		m_pCnctn->ForwardTargetSlot() = m_pOwner;
+	}
+	return *m_pCnctn;
+}
+
+template <typename... TArguments>
+inline TChainConnection<TArguments...>::operator ConnectionType& ()
+{
+	return Get();
+}
+
+template <typename... TArguments>
+inline TChainConnection<TArguments...>::operator ConnectionType const& () const
+{
+	return Get();
+}
+
+template <typename... TArguments>
+inline bool TChainConnection<TArguments...>::IsAllocated() const
+{
+	return (m_pCnctn != nullptr);
+}
+
+template <typename... TArguments>
+inline size_t TChainConnection<TArguments...>::MemoryUsage() const
+{
+	return (m_pCnctn != nullptr) ? CConnectionBase::c_nForwardHeaderSize + sizeof(ConnectionType) + m_pCnctn->MemoryUsage() : 0;
+}
+
+template <typename... TArguments>
+inline void TChainConnection<TArguments...>::Connect(NotificationType const& oNtfctn) const
+{
+	Get().Connect(oNtfctn);
+}
+
+template <typename... TArguments>
+inline bool TChainConnection<TArguments...>::Disconnect(CNotificationBase const& oNtfctn) const
+{
+	return (m_pCnctn != nullptr && m_pCnctn->Disconnect(oNtfctn));
+}
+
+template <typename... TArguments>
+inline void TChainConnection<TArguments...>::DisconnectAll() const
+{
+	if (m_pCnctn != nullptr)
+		m_pCnctn->DisconnectAll();
+}
+
+template <typename... TArguments>
+inline bool TChainConnection<TArguments...>::IsConnected(CNotificationBase const& oNtfctn) const
+{
+	return (m_pCnctn != nullptr && m_pCnctn->IsConnected(oNtfctn));
+}
+
+template <typename... TArguments>
+inline bool TChainConnection<TArguments...>::HasConnectedNotifications() const
+{
+	return (m_pCnctn != nullptr && m_pCnctn->HasConnectedNotifications());
+}
+
+template <typename... TArguments>
+inline bool TChainConnection<TArguments...>::IsMuted() const
+{
+	return (m_pCnctn != nullptr && m_pCnctn->IsMuted());
+}
+
+template <typename... TArguments>
+inline bool TChainConnection<TArguments...>::SetMuteState(bool bMute)
+{
+	return Get().SetMuteState(bMute);
+}
+
+template <typename... TArguments>
+inline CConnectionBase::CMuter TChainConnection<TArguments...>::Mute()
+{
+	return Get().Mute();
+}
+
+template <typename... TArguments>
+inline bool TChainConnection<TArguments...>::ConnectOnce(NotificationType const& oNtfctn)
+{
+	return Get().ConnectOnce(oNtfctn);
+}
+
+template <typename... TArguments>
+inline bool TChainConnection<TArguments...>::ConnectShots(NotificationType const& oNtfctn, uint32_t nShots)
+{
+	return Get().ConnectShots(oNtfctn, nShots);
+}
+
+template <typename... TArguments>
+inline bool TChainConnection<TArguments...>::SetShotLimit(uint32_t nShots)
+{
+	return Get().SetShotLimit(nShots);
+}
+
+template <typename... TArguments>
+inline uint32_t TChainConnection<TArguments...>::GetShotsLeft() const
+{
+	return (m_pCnctn != nullptr) ? m_pCnctn->GetShotsLeft() : 0;
+}
+
+template <typename... TArguments>
+inline void TChainConnection<TArguments...>::SetDeduplicated(bool bDedup)
+{
+	if (bDedup || m_pCnctn != nullptr)
+		Get().SetDeduplicated(bDedup);
+}
+
+template <typename... TArguments>
+inline bool TChainConnection<TArguments...>::IsDeduplicated() const
+{
+	return (m_pCnctn != nullptr && m_pCnctn->IsDeduplicated());
+}
+
+template <typename... TArguments>
+inline void TChainConnection<TArguments...>::ShrinkToFit() const
+{
+	if (m_pCnctn != nullptr)
+		m_pCnctn->ShrinkToFit();
+}
+
+template <typename... TArguments>
+template <typename TSender>
+inline void TChainConnection<TArguments...>::Invoke(TSender* pSenderObject, TArguments... args) const NCD_EMIT_NOEXCEPT
+{
+	// Connection which is not allocated is not muted, so the delegate is invoked directly
+	if (m_pCnctn != nullptr)
+		m_pCnctn->Invoke(pSenderObject, args...);
+	else if (!m_oDelegate.IsNull())
+	{
+		NCD_PROBE_INVOKE(this, m_oDelegate.GetStub(), m_oDelegate.GetTarget());
+		m_oDelegate(pSenderObject, args...);
+	}
+}
+
+template <typename... TArguments>
+inline typename TChainConnection<TArguments...>::DelegateType const& TChainConnection<TArguments...>::GetDelegate() const
+{
+	return m_oDelegate;
+}
+
+template <typename... TArguments>
+inline void TChainConnection<TArguments...>::SetOwner(CNotificationBase const* pOwner)
+{
+	m_pOwner = pOwner;
+	if (m_pCnctn != nullptr)
+		m_pCnctn->ForwardTargetSlot() = pOwner;
+}
+
+template <typename... TArguments>
+inline void TChainConnection<TArguments...>::Free()
+{
+	if (m_pCnctn != nullptr)
+	{
+		m_pCnctn->~ConnectionType();
+		::operator delete(reinterpret_cast<char*>(m_pCnctn) - CConnectionBase::c_nForwardHeaderSize);
+		m_pCnctn = nullptr;
+	}
+}
+
+template <typename... TArguments>
+inline void TChainConnection<TArguments...>::RebindTarget(void const* pOldTarget, void const* pNewTarget)
+{
+	m_oDelegate.Rebind(pOldTarget, pNewTarget);
+	if (m_pCnctn != nullptr)
+		m_pCnctn->RebindTarget(pOldTarget, pNewTarget);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 //	TNotification Implementation
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename... TArguments>
+inline TNotification<TArguments...>::TNotification()
+{
+#if defined(NCD_MEMORY_TALLY_ENABLED)
+	AttachTally(MemoryTallyOf<TNotification>());
+#endif
+}
+
 template <typename... TArguments>
 inline void TNotification<TArguments...>::AddConnection(ConnectionType const& oCnctn) const
 {
-	Add(&oCnctn);
-	if (!oCnctn.IsConnected(*this))
-		oCnctn.Connect(*this);
+	LinkConnection(oCnctn);
 }
 
 template <typename... TArguments>
 template <typename TSender>
-inline void TNotification<TArguments...>::Notify(TSender* pSender, TArguments... args) const
+inline void TNotification<TArguments...>::Notify(TSender* pSender, TArguments... args) const NCD_EMIT_NOEXCEPT
 {
+	if (m_pHook != nullptr)
+		static_cast<TNotificationHook<TArguments...> const*>(m_pHook)->OnEmit(pSender, args...);
+	SEpoch* pCascade = nullptr;
 	if (!m_blocked)
 	{
 		// Go through connections and invoke them
-		for (CConnectionBase const* pCnctnBase : m_aConnections)
+		// Connections could be removed while invoking (they leave holes), connections added meanwhile are not invoked
+		// Plain emission (no tracked connections) skips deduplication and shot counting
+		CEmitScope oScope(*this);
+		SEpoch const* const pEpoch = oScope.GetEpoch();
+		pCascade = oScope.GetCascade();
+		size_t const nCount = m_aConnections.size();
+		NCD_PROBE_NOTIFY_ENTRY(this, nCount);
+		for (size_t i = 0; i < nCount; ++i)
 		{
-			//ASSERT_PTR(pCnctnBase);
-			ConnectionType const* pCnctn = static_cast<ConnectionType const*>(pCnctnBase);
-			pCnctn->template Invoke<TSender>(pSender, args...);
+			CConnectionBase const* pCnctnBase = m_aConnections[i];
+			if (pCnctnBase != nullptr)
+			{
+				if (pEpoch != nullptr)
+				{
+					if (pCnctnBase->IsDeduplicated() && !EnterEpoch(*pEpoch, *pCnctnBase))
+						continue;
+					if (pCnctnBase->GetShotsLeft() != 0)
+						ConsumeShot(i);
+				}
+				ConnectionType const* pCnctn = static_cast<ConnectionType const*>(pCnctnBase);
+#if NCD_EXCEPTION_POLICY == NCD_EXCEPTIONS_ISOLATE
+				try
+				{
+					pCnctn->template Invoke<TSender>(pSender, args...);
+				}
+				catch (...)
+				{
+					ReportEmissionError(std::current_exception(), *this, *pCnctnBase);
+				}
+#else
+				pCnctn->template Invoke<TSender>(pSender, args...);
+#endif
+			}
 		}
+		NCD_PROBE_NOTIFY_EXIT(this);
 	}
+	// Top-level emission runs the hooks scheduled during its cascade (after its scope is closed)
+	if (pCascade != nullptr && pCascade->pFirstHook != nullptr)
+		EndCascade(*pCascade);
 }
 
 template <typename... TArguments>
@@ -1226,13 +3273,50 @@ inline TNotification<TArguments...>& TNotification<TArguments...>::operator -= (
 	return *this;
 }
 
+template <typename... TArguments>
+template <typename TSender, typename TProducer>
+inline bool TNotification<TArguments...>::NotifyLazy(TSender* pSender, TProducer&& fnProducer) const
+{
+	if (!HasActiveListeners() && m_pHook == nullptr)
+		return false;
+	EmitProduced(pSender, fnProducer(), std::integral_constant<bool, sizeof...(TArguments) == 1>());
+	return true;
+}
+
+template <typename... TArguments>
+inline void TNotification<TArguments...>::SetHook(TNotificationHook<TArguments...> const* pHook)
+{
+	m_pHook = pHook;
+}
+
 template <typename... TArguments>
 template <typename TSender>
-inline void TNotification<TArguments...>::operator () (TSender* pSender, TArguments... args) const
+inline void TNotification<TArguments...>::operator () (TSender* pSender, TArguments... args) const NCD_EMIT_NOEXCEPT
 {
 	Notify(pSender, args...);
 }
 
+template <typename... TArguments>
+template <typename TSender, typename TValue>
+inline void TNotification<TArguments...>::EmitProduced(TSender* pSender, TValue&& tValue, std::true_type) const
+{
+	Notify(pSender, std::forward<TValue>(tValue));
+}
+
+template <typename... TArguments>
+template <typename TSender, typename TTuple>
+inline void TNotification<TArguments...>::EmitProduced(TSender* pSender, TTuple&& tArgs, std::false_type) const
+{
+	EmitUnpacked(pSender, tArgs, std::index_sequence_for<TArguments...>());
+}
+
+template <typename... TArguments>
+template <typename TSender, typename TTuple, size_t... tIdx>
+inline void TNotification<TArguments...>::EmitUnpacked(TSender* pSender, TTuple& tArgs, std::index_sequence<tIdx...>) const
+{
+	Notify(pSender, std::get<tIdx>(tArgs)...);
+}
+
 //
 //	TNotifactionX
 //
@@ -1242,43 +3326,100 @@ inline TNotificationX<TSender, TArguments...>::TNotificationX()
 	using Me = TNotificationX<TSender, TArguments...>;
 	using DelegateType = typename ConnectionType::DelegateType;
 	cnt_Notify.Init(DelegateType::template CreateEx<TSender, Me, &Me::Notify>(*this));
+	cnt_Notify.SetOwner(this);
+}
+
+template <class TSender, typename... TArguments>
+inline TNotificationX<TSender, TArguments...>::TNotificationX(TNotificationX&& other) :
+	NotificationType(std::move(other)), cnt_Notify(std::move(other.cnt_Notify))
+{
+	cnt_Notify.RebindTarget(&other, this);
+	cnt_Notify.SetOwner(this);
+}
+
+template <class TSender, typename... TArguments>
+inline TNotificationX<TSender, TArguments...>& TNotificationX<TSender, TArguments...>::operator=(TNotificationX&& other)
+{
+	NotificationType::operator=(std::move(other));
+	cnt_Notify = std::move(other.cnt_Notify);
+	cnt_Notify.RebindTarget(&other, this);
+	cnt_Notify.SetOwner(this);
+	return *this;
 }
 
 template <class TSender, typename... TArguments>
-inline void TNotificationX<TSender, TArguments...>::Notify(TSender* pSender, TArguments... args) const
+inline void TNotificationX<TSender, TArguments...>::Notify(TSender* pSender, TArguments... args) const NCD_EMIT_NOEXCEPT
 {
 	NotificationType::template Notify<TSender>(pSender, args...);
 }
 
 template <class TSender, typename... TArguments>
-inline void TNotificationX<TSender, TArguments...>::operator() (TSender* pSender, TArguments... args) const
+inline void TNotificationX<TSender, TArguments...>::operator() (TSender* pSender, TArguments... args) const NCD_EMIT_NOEXCEPT
 {
 	Notify(pSender, args...);
 }
 
+template <class TSender, typename... TArguments>
+template <typename TProducer>
+inline bool TNotificationX<TSender, TArguments...>::NotifyLazy(TSender* pSender, TProducer&& fnProducer) const
+{
+	return NotificationType::template NotifyLazy<TSender>(pSender, std::forward<TProducer>(fnProducer));
+}
+
+template <class TSender, typename... TArguments>
+inline size_t TNotificationX<TSender, TArguments...>::MemoryUsage() const
+{
+	return NotificationType::MemoryUsage() + cnt_Notify.MemoryUsage();
+}
+
 //
 //	TNotifactionEX
 //
 template <class TSender, typename... TArguments>
 inline TNotificationEX<TSender, TArguments...>::TNotificationEX(TSender& owner) :
-	m_oSender(owner)
+	m_pSender(&owner)
 {
+	m_oSender.Capture(this, &owner, sizeof(TSender));
 	using Me = TNotificationEX<TSender, TArguments...>;
 	using DelegateType = typename ConnectionType::DelegateType;
 	Base::cnt_Notify.Init(DelegateType::template Create<Me, &Me::Notify>(*this));
 }
 
 template <class TSender, typename... TArguments>
-inline void TNotificationEX<TSender, TArguments...>::Notify(TArguments... args) const
+inline TNotificationEX<TSender, TArguments...>::TNotificationEX(TNotificationEX&& other) :
+	Base(std::move(other)),
+	m_pSender(other.m_oSender.IsEmbedded() ? static_cast<TSender*>(other.m_oSender.GetOwner(this)) : other.m_pSender),
+	m_oSender(other.m_oSender)
+{
+}
+
+template <class TSender, typename... TArguments>
+inline TNotificationEX<TSender, TArguments...>& TNotificationEX<TSender, TArguments...>::operator=(TNotificationEX&& other)
+{
+	Base::operator=(std::move(other));
+	m_oSender = other.m_oSender;
+	m_pSender = m_oSender.IsEmbedded() ? static_cast<TSender*>(m_oSender.GetOwner(this)) : other.m_pSender;
+	return *this;
+}
+
+template <class TSender, typename... TArguments>
+inline void TNotificationEX<TSender, TArguments...>::Notify(TArguments... args) const NCD_EMIT_NOEXCEPT
 {
-	Base::Notify(&m_oSender, args...);
+	Base::Notify(m_pSender, args...);
 }
 
 template <class TSender, typename... TArguments>
-inline void TNotificationEX<TSender, TArguments...>::operator() (TArguments... args) const
+inline void TNotificationEX<TSender, TArguments...>::operator() (TArguments... args) const NCD_EMIT_NOEXCEPT
 {
 	Notify(args...);
 }
+
+template <class TSender, typename... TArguments>
+template <typename TProducer>
+inline bool TNotificationEX<TSender, TArguments...>::NotifyLazy(TProducer&& fnProducer) const
+{
+	return Base::NotifyLazy(m_pSender, std::forward<TProducer>(fnProducer));
+}
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
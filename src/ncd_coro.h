@@ -0,0 +1,492 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Coroutine support (C++20)
+//
+//	Notifications could be awaited: coroutine suspends and resumes with the arguments of the next emission
+//	Awaiter lives in the coroutine frame and owns its connection, so suspension costs no heap allocation
+//	and the link is removed automatically when the awaiter is destroyed
+//	With the scheduler the coroutine is resumed later from the scheduler loop, otherwise when the emission cascade ends:
+//	the top-level Notify resumes it after closing its emission, so the coroutine may destroy the notification,
+//	its sender or the awaiting coroutine itself; awaiting outside of any emission (direct Invoke) resumes at once
+//	Waiting with timeout requires the scheduler, it keeps timers and runs expired ones
+//	Scheduler is single threaded: notifications should be emitted on the thread running the scheduler
+//
+//	Usage example
+//
+/*
+	CTask CClient::Request(CScheduler& oScheduler)
+	{
+		m_oServer.Send(...);
+		auto [nCode] = co_await m_oServer.ResponseReceived;
+
+		auto oReply = co_await NextEmission(m_oServer.DataReceived,
+											[](int nId, SData const&) {return nId == 42;},
+											oScheduler, std::chrono::seconds(5));
+		if (!oReply)
+			...	// timed out
+	}
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_CORO_H
+#define NCD_CORO_H
+
+#if !defined(__cpp_impl_coroutine)
+#error "ncd_coro.h requires C++20 coroutine support"
+#endif
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <tuple>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CTask
+//	Fire-and-forget coroutine type, starts immediately and destroys its frame upon completion
+//
+class CTask
+{
+public:
+	struct promise_type
+	{
+		inline CTask get_return_object() noexcept {return CTask();}
+		inline std::suspend_never initial_suspend() noexcept {return {};}
+		inline std::suspend_never final_suspend() noexcept {return {};}
+		inline void return_void() noexcept {}
+		inline void unhandled_exception() noexcept {std::terminate();}
+	};
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CScheduler
+//	Simple single threaded run loop for suspended coroutines
+//	Keeps ready queue and timers as intrusive lists of wait nodes owned by awaiters (no allocations)
+//
+class CScheduler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	//
+	//	Wait node, embedded into awaiters
+	//
+	struct SWaitNode
+	{
+		std::coroutine_handle<>	hCoro;
+		Clock::time_point		tDeadline;
+		SWaitNode*				pPrevTimer = nullptr;
+		SWaitNode*				pNextTimer = nullptr;
+		SWaitNode*				pNextReady = nullptr;
+		bool					bTimerLinked = false;
+		bool					bReady = false;
+		bool					bTimedOut = false;
+	};
+
+public:
+	inline CScheduler() = default;
+	inline ~CScheduler();
+
+	CScheduler(CScheduler const&) = delete;
+	void operator=(CScheduler const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Scheduler bound to the calling thread (the one running or explicitly made current), could be null
+	static inline CScheduler* Current();
+	// Binds scheduler to the calling thread, returns previously bound one
+	inline CScheduler* MakeCurrent();
+
+	// Returns true if there are ready coroutines or pending timers
+	inline bool HasWork() const;
+
+	// Resumes ready coroutines and the ones with expired timers, returns number of resumed coroutines
+	inline size_t RunPending();
+	// Runs until there is no more ready coroutines and timers, sleeps until the nearest deadline when idle
+	inline void Run();
+
+	// Queues wait node for resumption
+	inline void Post(SWaitNode& oNode);
+	// Arms/disarms wait node timer
+	inline void AddTimer(SWaitNode& oNode, Clock::time_point tDeadline);
+	inline void RemoveTimer(SWaitNode& oNode);
+	// Removes wait node from all queues
+	inline void Cancel(SWaitNode& oNode);
+
+private:
+	//
+	//	Implementation
+	//
+	inline void ExpireTimers(Clock::time_point tNow);
+	inline bool GetNearestDeadline(Clock::time_point& tDeadline) const;
+
+	static inline CScheduler*& CurrentRef();
+
+private:
+	//
+	//	Contents
+	//
+	SWaitNode*	m_pReadyHead = nullptr;
+	SWaitNode*	m_pReadyTail = nullptr;
+	SWaitNode*	m_pTimers = nullptr;
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TEmissionAwaiter
+//	Awaits the next emission of the notification accepted by the predicate
+//	Resumes with std::optional of arguments tuple, which is empty if the timeout expired
+//
+struct SAcceptAll
+{
+	template <typename... TArguments>
+	inline bool operator() (TArguments const&...) const {return true;}
+};
+
+template <typename TPredicate, typename... TArguments>
+class TEmissionAwaiter : private CCascadeHook
+{
+public:
+	using NotificationType = TNotification<TArguments...>;
+	using ConnectionType = TConnection<TArguments...>;
+	using ValueType = std::tuple<std::decay_t<TArguments>...>;
+	using Clock = CScheduler::Clock;
+
+	inline TEmissionAwaiter(NotificationType const& oNtfctn, TPredicate fnPredicate,
+							CScheduler* pScheduler, Clock::duration tTimeout = Clock::duration::max());
+	inline ~TEmissionAwaiter();
+
+	TEmissionAwaiter(TEmissionAwaiter const&) = delete;
+	void operator=(TEmissionAwaiter const&) = delete;
+
+	//
+	//	Awaiter interface
+	//
+	inline bool await_ready() const noexcept {return false;}
+	inline void await_suspend(std::coroutine_handle<> hCoro);
+	inline std::optional<ValueType> await_resume();
+
+private:
+	//
+	//	Implementation
+	//
+	inline void OnEmission(TArguments... args);
+	// Resumes the coroutine deferred by the emission
+	inline void OnCascadeEnd() override;
+
+private:
+	//
+	//	Contents
+	//
+	NotificationType const&		m_oNtfctn;
+	TPredicate					m_fnPredicate;
+	CScheduler*					m_pScheduler;
+	Clock::duration				m_tTimeout;
+	CScheduler::SWaitNode		m_oNode;
+	ConnectionType				m_oCnctn;
+	std::optional<ValueType>	m_tResult;
+	bool						m_bWaiting = false;
+};
+
+//
+//	Awaiter of the next emission without timeout, resumes with arguments tuple
+//
+template <typename TPredicate, typename... TArguments>
+class TNextEmissionAwaiter : public TEmissionAwaiter<TPredicate, TArguments...>
+{
+public:
+	using Base = TEmissionAwaiter<TPredicate, TArguments...>;
+	using Base::Base;
+
+	inline typename Base::ValueType await_resume()
+		{return std::move(*Base::await_resume());}
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+//
+//	Awaitable helpers
+//
+
+// co_await oNtfctn - resumes with the next emission arguments (through the current scheduler if any)
+template <typename... TArguments>
+inline TNextEmissionAwaiter<SAcceptAll, TArguments...> operator co_await(TNotification<TArguments...> const& oNtfctn)
+{
+	return TNextEmissionAwaiter<SAcceptAll, TArguments...>(oNtfctn, SAcceptAll(), CScheduler::Current());
+}
+
+// Resumes with the next emission arguments accepted by the predicate
+template <typename... TArguments, typename TPredicate>
+inline TNextEmissionAwaiter<TPredicate, TArguments...> NextEmission(TNotification<TArguments...> const& oNtfctn,
+																	TPredicate fnPredicate)
+{
+	return TNextEmissionAwaiter<TPredicate, TArguments...>(oNtfctn, fnPredicate, CScheduler::Current());
+}
+
+// Resumes with the next emission arguments accepted by the predicate or with empty optional when timeout expires
+template <typename... TArguments, typename TPredicate>
+inline TEmissionAwaiter<TPredicate, TArguments...> NextEmission(TNotification<TArguments...> const& oNtfctn,
+																TPredicate fnPredicate, CScheduler& oScheduler,
+																CScheduler::Clock::duration tTimeout)
+{
+	return TEmissionAwaiter<TPredicate, TArguments...>(oNtfctn, fnPredicate, &oScheduler, tTimeout);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CScheduler Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline CScheduler::~CScheduler()
+{
+	if (CurrentRef() == this)
+		CurrentRef() = nullptr;
+}
+
+inline CScheduler*& CScheduler::CurrentRef()
+{
+	static thread_local CScheduler* s_pCurrent = nullptr;
+	return s_pCurrent;
+}
+
+inline CScheduler* CScheduler::Current()
+{
+	return CurrentRef();
+}
+
+inline CScheduler* CScheduler::MakeCurrent()
+{
+	CScheduler* pPrev = CurrentRef();
+	CurrentRef() = this;
+	return pPrev;
+}
+
+inline bool CScheduler::HasWork() const
+{
+	return (m_pReadyHead != nullptr || m_pTimers != nullptr);
+}
+
+inline size_t CScheduler::RunPending()
+{
+	CScheduler* pPrev = MakeCurrent();
+
+	ExpireTimers(Clock::now());
+
+	size_t nResumed = 0;
+	while (m_pReadyHead != nullptr)
+	{
+		SWaitNode* pNode = m_pReadyHead;
+		m_pReadyHead = pNode->pNextReady;
+		if (m_pReadyHead == nullptr)
+			m_pReadyTail = nullptr;
+		pNode->pNextReady = nullptr;
+		pNode->bReady = false;
+
+		++nResumed;
+		pNode->hCoro.resume();	// Node could be destroyed here
+	}
+
+	CurrentRef() = pPrev;
+	return nResumed;
+}
+
+inline void CScheduler::Run()
+{
+	while (HasWork())
+	{
+		if (RunPending() == 0)
+		{
+			Clock::time_point tDeadline;
+			if (GetNearestDeadline(tDeadline))
+				std::this_thread::sleep_until(tDeadline);
+		}
+	}
+}
+
+inline void CScheduler::Post(SWaitNode& oNode)
+{
+	RemoveTimer(oNode);
+	if (oNode.bReady)
+		return;
+	oNode.bReady = true;
+	oNode.pNextReady = nullptr;
+	if (m_pReadyTail != nullptr)
+		m_pReadyTail->pNextReady = &oNode;
+	else
+		m_pReadyHead = &oNode;
+	m_pReadyTail = &oNode;
+}
+
+inline void CScheduler::AddTimer(SWaitNode& oNode, Clock::time_point tDeadline)
+{
+	RemoveTimer(oNode);
+	oNode.tDeadline = tDeadline;
+	oNode.bTimedOut = false;
+	oNode.bTimerLinked = true;
+	oNode.pPrevTimer = nullptr;
+	oNode.pNextTimer = m_pTimers;
+	if (m_pTimers != nullptr)
+		m_pTimers->pPrevTimer = &oNode;
+	m_pTimers = &oNode;
+}
+
+inline void CScheduler::RemoveTimer(SWaitNode& oNode)
+{
+	if (!oNode.bTimerLinked)
+		return;
+	if (oNode.pPrevTimer != nullptr)
+		oNode.pPrevTimer->pNextTimer = oNode.pNextTimer;
+	else
+		m_pTimers = oNode.pNextTimer;
+	if (oNode.pNextTimer != nullptr)
+		oNode.pNextTimer->pPrevTimer = oNode.pPrevTimer;
+	oNode.pPrevTimer = oNode.pNextTimer = nullptr;
+	oNode.bTimerLinked = false;
+}
+
+inline void CScheduler::Cancel(SWaitNode& oNode)
+{
+	RemoveTimer(oNode);
+	if (!oNode.bReady)
+		return;
+
+	SWaitNode* pPrev = nullptr;
+	for (SWaitNode* pNode = m_pReadyHead; pNode != nullptr; pPrev = pNode, pNode = pNode->pNextReady)
+	{
+		if (pNode == &oNode)
+		{
+			if (pPrev != nullptr)
+				pPrev->pNextReady = pNode->pNextReady;
+			else
+				m_pReadyHead = pNode->pNextReady;
+			if (m_pReadyTail == pNode)
+				m_pReadyTail = pPrev;
+			break;
+		}
+	}
+	oNode.pNextReady = nullptr;
+	oNode.bReady = false;
+}
+
+inline void CScheduler::ExpireTimers(Clock::time_point tNow)
+{
+	SWaitNode* pNode = m_pTimers;
+	while (pNode != nullptr)
+	{
+		SWaitNode* pNext = pNode->pNextTimer;
+		if (pNode->tDeadline <= tNow)
+		{
+			pNode->bTimedOut = true;
+			Post(*pNode);
+		}
+		pNode = pNext;
+	}
+}
+
+inline bool CScheduler::GetNearestDeadline(Clock::time_point& tDeadline) const
+{
+	if (m_pTimers == nullptr)
+		return false;
+	tDeadline = m_pTimers->tDeadline;
+	for (SWaitNode const* pNode = m_pTimers->pNextTimer; pNode != nullptr; pNode = pNode->pNextTimer)
+		tDeadline = (std::min)(tDeadline, pNode->tDeadline);
+	return true;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TEmissionAwaiter Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename TPredicate, typename... TArguments>
+inline TEmissionAwaiter<TPredicate, TArguments...>::TEmissionAwaiter(
+	NotificationType const& oNtfctn, TPredicate fnPredicate, CScheduler* pScheduler, Clock::duration tTimeout) :
+	m_oNtfctn(oNtfctn), m_fnPredicate(fnPredicate), m_pScheduler(pScheduler), m_tTimeout(tTimeout)
+{
+}
+
+template <typename TPredicate, typename... TArguments>
+inline TEmissionAwaiter<TPredicate, TArguments...>::~TEmissionAwaiter()
+{
+	if (m_pScheduler != nullptr)
+		m_pScheduler->Cancel(m_oNode);
+}
+
+template <typename TPredicate, typename... TArguments>
+inline void TEmissionAwaiter<TPredicate, TArguments...>::await_suspend(std::coroutine_handle<> hCoro)
+{
+	using Me = TEmissionAwaiter<TPredicate, TArguments...>;
+	using DelegateType = typename ConnectionType::DelegateType;
+
+	m_oNode.hCoro = hCoro;
+	m_bWaiting = true;
+	m_oCnctn.SetCascadeListener(true);
+	m_oCnctn.Init(m_oNtfctn, DelegateType::template Create<Me, &Me::OnEmission>(*this));
+
+	if (m_pScheduler != nullptr && m_tTimeout != Clock::duration::max())
+		m_pScheduler->AddTimer(m_oNode, Clock::now() + m_tTimeout);
+}
+
+template <typename TPredicate, typename... TArguments>
+inline std::optional<typename TEmissionAwaiter<TPredicate, TArguments...>::ValueType>
+TEmissionAwaiter<TPredicate, TArguments...>::await_resume()
+{
+	m_bWaiting = false;
+	m_oCnctn.DisconnectAll();
+	return std::move(m_tResult);
+}
+
+template <typename TPredicate, typename... TArguments>
+inline void TEmissionAwaiter<TPredicate, TArguments...>::OnEmission(TArguments... args)
+{
+	// Ignore emissions after the first accepted one or after the timeout
+	if (!m_bWaiting || m_oNode.bTimedOut || m_oNode.bReady || !m_fnPredicate(args...))
+		return;
+
+	m_tResult.emplace(args...);
+	m_bWaiting = false;
+	if (m_pScheduler != nullptr)
+		m_pScheduler->Post(m_oNode);
+	else if (!Schedule())
+		m_oNode.hCoro.resume();	// Not emitting, nothing on the stack refers to the notification
+}
+
+template <typename TPredicate, typename... TArguments>
+inline void TEmissionAwaiter<TPredicate, TArguments...>::OnCascadeEnd()
+{
+	m_oNode.hCoro.resume();
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_CORO_H
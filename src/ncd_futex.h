@@ -0,0 +1,132 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Address based wait/wake primitive used by the blocking parts of the NCD infrastructure
+//
+//	Thread blocks while 32 bit word keeps expected value and wakes up when other side changes the word and calls Wake
+//	Maps directly to futex on Linux and to WaitOnAddress on Windows, other platforms fall back to polling with yield
+//	Shared (cross-process) waits are supported only on Linux, word should reside in the shared memory in that case
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_FUTEX_H
+#define NCD_FUTEX_H
+
+//
+//	Includes
+//
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+#include <cerrno>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+namespace futex {
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Futex word should be lock free 32 bit atomic");
+
+//
+//	Blocks while oWord equals to uExpected or until Wake called
+//	Returns false if the timeout expired, true otherwise (spurious wakeups are possible, caller should recheck)
+//	Negative timeout means infinite wait
+//
+inline bool Wait(std::atomic<uint32_t> const& oWord, uint32_t uExpected,
+				 std::chrono::nanoseconds tTimeout = std::chrono::nanoseconds(-1), bool bShared = false)
+{
+#if defined(__linux__)
+	timespec tSpec;
+	timespec* pSpec = nullptr;
+	if (tTimeout.count() >= 0)
+	{
+		tSpec.tv_sec = static_cast<time_t>(tTimeout.count() / 1000000000);
+		tSpec.tv_nsec = static_cast<long>(tTimeout.count() % 1000000000);
+		pSpec = &tSpec;
+	}
+	long nRes = ::syscall(SYS_futex, reinterpret_cast<uint32_t const*>(&oWord),
+						  bShared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE, uExpected, pSpec, nullptr, 0);
+	return !(nRes != 0 && errno == ETIMEDOUT);
+#elif defined(_WIN32)
+	(void) bShared;
+	// WaitOnAddress takes milliseconds: timeout is rounded up, so short waits do not turn into the busy polling,
+	// and clamped below INFINITE
+	DWORD dwMs = INFINITE;
+	if (tTimeout.count() >= 0)
+	{
+		auto const nMs = std::chrono::ceil<std::chrono::milliseconds>(tTimeout).count();
+		dwMs = (nMs < static_cast<decltype(nMs)>(INFINITE)) ? static_cast<DWORD>(nMs) : INFINITE - 1;
+	}
+	BOOL bRes = ::WaitOnAddress(const_cast<std::atomic<uint32_t>*>(&oWord), &uExpected, sizeof(uint32_t), dwMs);
+	return !(bRes == FALSE && ::GetLastError() == ERROR_TIMEOUT);
+#else
+	(void) bShared;
+	auto tDeadline = std::chrono::steady_clock::now() + tTimeout;
+	while (oWord.load(std::memory_order_acquire) == uExpected)
+	{
+		if (tTimeout.count() >= 0 && std::chrono::steady_clock::now() >= tDeadline)
+			return false;
+		std::this_thread::yield();
+	}
+	return true;
+#endif
+}
+
+//
+//	Wakes up to one thread blocked on the oWord
+//
+inline void WakeOne(std::atomic<uint32_t>& oWord, bool bShared = false)
+{
+#if defined(__linux__)
+	::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&oWord), bShared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+	(void) bShared;
+	::WakeByAddressSingle(&oWord);
+#else
+	(void) oWord; (void) bShared;
+#endif
+}
+
+//
+//	Wakes all threads blocked on the oWord
+//
+inline void WakeAll(std::atomic<uint32_t>& oWord, bool bShared = false)
+{
+#if defined(__linux__)
+	::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&oWord), bShared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+	(void) bShared;
+	::WakeByAddressAll(&oWord);
+#else
+	(void) oWord; (void) bShared;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace futex
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_FUTEX_H
@@ -0,0 +1,440 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Notification - Connection graph introspection
+//
+//	Snapshot walks the live graph starting from the specified roots: notifications lead to their connections,
+//	connections lead to all their notifications and, for the cnt_Notify connections, to the chained notification
+//	For every node it reports fan-out, fan-in, mute/block state and the depth of the notification chain,
+//	snapshot could be exported in the DOT (graphviz) or JSON format
+//	Nodes of the notification cycles are marked, the chain depth does not count the steps around a cycle
+//	Walk costs O(nodes + links) and does not modify the graph, it should be made on the thread owning the graph
+//	Walk does not recurse, so arbitrary long chains do not exhaust the stack
+//
+//	Usage example
+//
+/*
+	CGraphSnapshot oSnapshot;
+	oSnapshot.AddRoot(oModel.ntfChanged);
+	oSnapshot.SetLabel(&oModel.ntfChanged, "Model::Changed");
+	oSnapshot.Capture();
+	if (oSnapshot.GetMaxFanOut() > 1000)
+		save("graph.dot", oSnapshot.ToDot());
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_GRAPH_H
+#define NCD_GRAPH_H
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CGraphSnapshot
+//	Snapshot of the reachable part of the Notification - Connection graph
+//
+class CGraphSnapshot
+{
+public:
+	enum class ENodeKind
+	{
+		Notification,
+		Connection
+	};
+
+	struct SNode
+	{
+		void const*	pAddress;
+		ENodeKind	eKind;
+		bool		bDisabled;		// Notification is blocked or connection is muted
+		bool		bInCycle;		// Node is a part of a notification cycle (emission would never end)
+		size_t		nFanOut;		// Notification: number of connections, connection: 1 if it chains a notification
+		size_t		nFanIn;			// Notification: number of chained notifications, connection: number of notifications
+		size_t		nChainDepth;	// Longest chain of notifications emitted (directly or not) by this node
+		std::string	sLabel;
+	};
+
+	// Link between nodes (indexes), from notification to connection or from cnt_Notify to its notification
+	struct SEdge
+	{
+		size_t	nFrom;
+		size_t	nTo;
+	};
+
+public:
+	inline CGraphSnapshot() = default;
+
+	// Adds starting points of the walk
+	inline void AddRoot(CNotificationBase const& oNtfctn);
+	inline void AddRoot(CConnectionBase const& oCnctn);
+	// Assigns human readable name to the notification or connection
+	inline void SetLabel(void const* pObject, std::string sLabel);
+
+	// Walks the graph from the roots and rebuilds the snapshot
+	inline void Capture();
+	// Forgets roots, labels and captured snapshot
+	inline void Clear();
+
+	inline std::vector<SNode> const& GetNodes() const;
+	inline std::vector<SEdge> const& GetEdges() const;
+	inline size_t GetMaxFanOut() const;
+	inline size_t GetMaxFanIn() const;
+	inline size_t GetMaxChainDepth() const;
+	inline size_t GetCycleNodeCount() const;
+
+	// Exports captured snapshot
+	inline std::string ToDot() const;
+	inline std::string ToJson() const;
+
+private:
+	//
+	//	Implementation
+	//
+	inline size_t Visit(void const* pObject, ENodeKind eKind);
+	inline void ComputeChainDepths();
+	static inline std::string Escape(std::string const& sText);
+	inline std::string GetName(SNode const& oNode) const;
+
+private:
+	//
+	//	Contents
+	//
+	std::vector<CNotificationBase const*>			m_aRootNtfctns;
+	std::vector<CConnectionBase const*>				m_aRootCnctns;
+	std::unordered_map<void const*, std::string>	m_mapLabels;
+
+	std::vector<SNode>								m_aNodes;
+	std::vector<SEdge>								m_aEdges;
+	std::vector<std::vector<size_t>>				m_aNext;		// Adjacency by node index
+	std::unordered_map<void const*, size_t>			m_mapNtfctns;	// Address to node index
+	std::unordered_map<void const*, size_t>			m_mapCnctns;
+	std::vector<size_t>								m_aPending;		// Nodes waiting to be expanded
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CGraphSnapshot Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline void CGraphSnapshot::AddRoot(CNotificationBase const& oNtfctn)
+{
+	m_aRootNtfctns.push_back(&oNtfctn);
+}
+
+inline void CGraphSnapshot::AddRoot(CConnectionBase const& oCnctn)
+{
+	m_aRootCnctns.push_back(&oCnctn);
+}
+
+inline void CGraphSnapshot::SetLabel(void const* pObject, std::string sLabel)
+{
+	m_mapLabels[pObject] = std::move(sLabel);
+}
+
+inline void CGraphSnapshot::Capture()
+{
+	m_aNodes.clear();
+	m_aEdges.clear();
+	m_aNext.clear();
+	m_mapNtfctns.clear();
+	m_mapCnctns.clear();
+	m_aPending.clear();
+
+	for (CNotificationBase const* pNtfctn : m_aRootNtfctns)
+		Visit(pNtfctn, ENodeKind::Notification);
+	for (CConnectionBase const* pCnctn : m_aRootCnctns)
+		Visit(pCnctn, ENodeKind::Connection);
+
+	// Expand nodes breadth first, each node is expanded exactly once so every link is recorded once
+	for (size_t nPos = 0; nPos < m_aPending.size(); ++nPos)
+	{
+		size_t const nNode = m_aPending[nPos];
+		if (m_aNodes[nNode].eKind == ENodeKind::Notification)
+		{
+			CNotificationBase const* pNtfctn = static_cast<CNotificationBase const*>(m_aNodes[nNode].pAddress);
+			m_aNodes[nNode].bDisabled = pNtfctn->IsBlocked();
+			pNtfctn->ForEachConnection([&](CConnectionBase const& oCnctn)
+			{
+				size_t const nCnctn = Visit(&oCnctn, ENodeKind::Connection);
+				m_aEdges.push_back(SEdge {nNode, nCnctn});
+				m_aNext[nNode].push_back(nCnctn);
+				++m_aNodes[nNode].nFanOut;
+			});
+		}
+		else
+		{
+			CConnectionBase const* pCnctn = static_cast<CConnectionBase const*>(m_aNodes[nNode].pAddress);
+			m_aNodes[nNode].bDisabled = pCnctn->IsMuted();
+			pCnctn->ForEachNotification([&](CNotificationBase const& oNtfctn)
+			{
+				Visit(&oNtfctn, ENodeKind::Notification);
+				++m_aNodes[nNode].nFanIn;
+			});
+			if (CNotificationBase const* pTarget = pCnctn->GetForwardTarget())
+			{
+				size_t const nTarget = Visit(pTarget, ENodeKind::Notification);
+				m_aEdges.push_back(SEdge {nNode, nTarget});
+				m_aNext[nNode].push_back(nTarget);
+				m_aNodes[nNode].nFanOut = 1;
+				++m_aNodes[nTarget].nFanIn;
+			}
+		}
+	}
+
+	ComputeChainDepths();
+}
+
+inline void CGraphSnapshot::Clear()
+{
+	m_aRootNtfctns.clear();
+	m_aRootCnctns.clear();
+	m_mapLabels.clear();
+	m_aNodes.clear();
+	m_aEdges.clear();
+	m_aNext.clear();
+	m_mapNtfctns.clear();
+	m_mapCnctns.clear();
+	m_aPending.clear();
+}
+
+inline std::vector<CGraphSnapshot::SNode> const& CGraphSnapshot::GetNodes() const
+{
+	return m_aNodes;
+}
+
+inline std::vector<CGraphSnapshot::SEdge> const& CGraphSnapshot::GetEdges() const
+{
+	return m_aEdges;
+}
+
+inline size_t CGraphSnapshot::GetMaxFanOut() const
+{
+	size_t nMax = 0;
+	for (SNode const& oNode : m_aNodes)
+		nMax = (oNode.nFanOut > nMax) ? oNode.nFanOut : nMax;
+	return nMax;
+}
+
+inline size_t CGraphSnapshot::GetMaxFanIn() const
+{
+	size_t nMax = 0;
+	for (SNode const& oNode : m_aNodes)
+		nMax = (oNode.nFanIn > nMax) ? oNode.nFanIn : nMax;
+	return nMax;
+}
+
+inline size_t CGraphSnapshot::GetMaxChainDepth() const
+{
+	size_t nMax = 0;
+	for (SNode const& oNode : m_aNodes)
+		nMax = (oNode.nChainDepth > nMax) ? oNode.nChainDepth : nMax;
+	return nMax;
+}
+
+inline size_t CGraphSnapshot::GetCycleNodeCount() const
+{
+	size_t nCount = 0;
+	for (SNode const& oNode : m_aNodes)
+		nCount += oNode.bInCycle ? 1 : 0;
+	return nCount;
+}
+
+inline std::string CGraphSnapshot::ToDot() const
+{
+	std::string sDot = "digraph ncd {\n";
+	for (size_t i = 0; i < m_aNodes.size(); ++i)
+	{
+		SNode const& oNode = m_aNodes[i];
+		sDot += "\tn" + std::to_string(i) + " [label=\"" + Escape(GetName(oNode)) +
+			"\\nout=" + std::to_string(oNode.nFanOut) + " in=" + std::to_string(oNode.nFanIn) +
+			" depth=" + std::to_string(oNode.nChainDepth) + "\", shape=" +
+			(oNode.eKind == ENodeKind::Notification ? "ellipse" : "box") +
+			(oNode.bDisabled ? ", style=dashed" : "") + (oNode.bInCycle ? ", color=red" : (oNode.bDisabled ? ", color=gray" : "")) + "];\n";
+	}
+	for (SEdge const& oEdge : m_aEdges)
+		sDot += "\tn" + std::to_string(oEdge.nFrom) + " -> n" + std::to_string(oEdge.nTo) + ";\n";
+	sDot += "}\n";
+	return sDot;
+}
+
+inline std::string CGraphSnapshot::ToJson() const
+{
+	std::string sJson = "{\"nodes\":[";
+	for (size_t i = 0; i < m_aNodes.size(); ++i)
+	{
+		SNode const& oNode = m_aNodes[i];
+		char szAddress[32];
+		std::snprintf(szAddress, sizeof(szAddress), "%p", oNode.pAddress);
+		sJson += (i != 0 ? ",{" : "{");
+		sJson += "\"id\":" + std::to_string(i) +
+			",\"kind\":\"" + (oNode.eKind == ENodeKind::Notification ? "notification" : "connection") +
+			"\",\"address\":\"" + szAddress +
+			"\",\"label\":\"" + Escape(oNode.sLabel) +
+			"\",\"disabled\":" + (oNode.bDisabled ? "true" : "false") +
+			",\"inCycle\":" + (oNode.bInCycle ? "true" : "false") +
+			",\"fanOut\":" + std::to_string(oNode.nFanOut) +
+			",\"fanIn\":" + std::to_string(oNode.nFanIn) +
+			",\"chainDepth\":" + std::to_string(oNode.nChainDepth) + "}";
+	}
+	sJson += "],\"edges\":[";
+	for (size_t i = 0; i < m_aEdges.size(); ++i)
+	{
+		sJson += (i != 0 ? ",[" : "[");
+		sJson += std::to_string(m_aEdges[i].nFrom) + "," + std::to_string(m_aEdges[i].nTo) + "]";
+	}
+	sJson += "]}";
+	return sJson;
+}
+
+inline size_t CGraphSnapshot::Visit(void const* pObject, ENodeKind eKind)
+{
+	auto& mapIndex = (eKind == ENodeKind::Notification) ? m_mapNtfctns : m_mapCnctns;
+	auto itNode = mapIndex.find(pObject);
+	if (itNode != mapIndex.end())
+		return itNode->second;
+
+	size_t const nNode = m_aNodes.size();
+	auto itLabel = m_mapLabels.find(pObject);
+	m_aNodes.push_back(SNode {pObject, eKind, false, false, 0, 0, 0,
+							  itLabel != m_mapLabels.end() ? itLabel->second : std::string()});
+	m_aNext.emplace_back();
+	mapIndex.emplace(pObject, nNode);
+	m_aPending.push_back(nNode);
+	return nNode;
+}
+
+inline void CGraphSnapshot::ComputeChainDepths()
+{
+	// Tarjan's strongly connected components with an explicit call stack. Components are completed sinks first,
+	// so when a component completes the depths of all nodes it leads to are already known
+	size_t const c_nNone = static_cast<size_t>(-1);
+	struct SFrame
+	{
+		size_t	nNode;
+		size_t	nNext;	// Next adjacent node to visit
+	};
+
+	std::vector<size_t> aIndex(m_aNodes.size(), c_nNone);
+	std::vector<size_t> aLowLink(m_aNodes.size(), 0);
+	std::vector<size_t> aComponent(m_aNodes.size(), c_nNone);
+	std::vector<size_t> aOpen;		// Visited nodes of the not yet completed components
+	std::vector<SFrame> aCalls;
+	size_t nCounter = 0;
+	size_t nComponents = 0;
+
+	for (size_t nRoot = 0; nRoot < m_aNodes.size(); ++nRoot)
+	{
+		if (aIndex[nRoot] != c_nNone)
+			continue;
+		aIndex[nRoot] = aLowLink[nRoot] = nCounter++;
+		aOpen.push_back(nRoot);
+		aCalls.push_back(SFrame {nRoot, 0});
+
+		while (!aCalls.empty())
+		{
+			size_t const nNode = aCalls.back().nNode;
+			if (aCalls.back().nNext < m_aNext[nNode].size())
+			{
+				size_t const nNext = m_aNext[nNode][aCalls.back().nNext++];
+				if (aIndex[nNext] == c_nNone)
+				{
+					aIndex[nNext] = aLowLink[nNext] = nCounter++;
+					aOpen.push_back(nNext);
+					aCalls.push_back(SFrame {nNext, 0});
+				}
+				else if (aComponent[nNext] == c_nNone && aIndex[nNext] < aLowLink[nNode])
+					aLowLink[nNode] = aIndex[nNext];
+				continue;
+			}
+
+			aCalls.pop_back();
+			if (!aCalls.empty() && aLowLink[nNode] < aLowLink[aCalls.back().nNode])
+				aLowLink[aCalls.back().nNode] = aLowLink[nNode];
+			if (aLowLink[nNode] != aIndex[nNode])
+				continue;
+
+			// Node is the root of a completed component, its members are on top of the open nodes
+			size_t nFirst = aOpen.size();
+			do
+				aComponent[aOpen[--nFirst]] = nComponents;
+			while (aOpen[nFirst] != nNode);
+
+			// Only connection -> notification steps make the chain longer, steps inside the component are not counted
+			bool bCycle = (aOpen.size() - nFirst > 1);
+			size_t nDepth = 0;
+			for (size_t nPos = nFirst; nPos < aOpen.size(); ++nPos)
+			{
+				size_t const nMember = aOpen[nPos];
+				size_t const nStep = (m_aNodes[nMember].eKind == ENodeKind::Connection) ? 1 : 0;
+				for (size_t nNext : m_aNext[nMember])
+				{
+					if (aComponent[nNext] == nComponents)
+						bCycle = true;
+					else if (m_aNodes[nNext].nChainDepth + nStep > nDepth)
+						nDepth = m_aNodes[nNext].nChainDepth + nStep;
+				}
+			}
+			for (size_t nPos = nFirst; nPos < aOpen.size(); ++nPos)
+			{
+				m_aNodes[aOpen[nPos]].nChainDepth = nDepth;
+				m_aNodes[aOpen[nPos]].bInCycle = bCycle;
+			}
+			aOpen.resize(nFirst);
+			++nComponents;
+		}
+	}
+}
+
+inline std::string CGraphSnapshot::Escape(std::string const& sText)
+{
+	std::string sResult;
+	sResult.reserve(sText.size());
+	for (char ch : sText)
+	{
+		if (ch == '"' || ch == '\\')
+			sResult += '\\';
+		if (static_cast<unsigned char>(ch) < 0x20)
+			sResult += ' ';
+		else
+			sResult += ch;
+	}
+	return sResult;
+}
+
+inline std::string CGraphSnapshot::GetName(SNode const& oNode) const
+{
+	if (!oNode.sLabel.empty())
+		return oNode.sLabel;
+
+	char szAddress[32];
+	std::snprintf(szAddress, sizeof(szAddress), "%p", oNode.pAddress);
+	return std::string(oNode.eKind == ENodeKind::Notification ? "ntf " : "cnt ") + szAddress;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_GRAPH_H
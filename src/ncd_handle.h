@@ -0,0 +1,349 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Generational connection handles
+//
+//	Deferred deliveries (thread handoff, timers, replay) should not keep raw connection pointers,
+//	receiver could be destroyed before the delivery takes place
+//	Handle map keeps connections in the slots, handle is the slot index and the generation of the slot
+//	Releasing the slot bumps its generation, so all handles issued before become stale
+//	Validation is a single load and compare, no reference counting per call
+//	Map is owned by the thread where its connections live: handles could travel to any thread,
+//	but they should be resolved (and deliveries executed) back on the owning thread
+//
+//	Usage example
+//
+/*
+	class CView
+	{
+	public:
+		void onData(int nValue);
+
+		HandleConnection<int>	cnt_onData {*this, HandleConnection<int>::DelegateType::Create<CView, &CView::onData>(*this)};
+	};
+
+	auto hView = oView.cnt_onData.GetHandle();					// on the UI thread
+		...
+	PostToUiThread([hView, pModel, nValue]() {
+		CHandleMap::ThreadDefault().Invoke(hView, pModel, nValue);	// does nothing if the view is gone
+	});
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_HANDLE_H
+#define NCD_HANDLE_H
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+
+#include <cstdint>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	SConnectionHandle
+//	Slot index and generation, zero generation stands for the null handle
+//
+struct SConnectionHandle
+{
+	uint32_t nIndex = 0;
+	uint32_t nGeneration = 0;
+
+	inline bool IsNull() const { return (nGeneration == 0); }
+
+	inline bool operator == (SConnectionHandle const& o) const { return (nIndex == o.nIndex && nGeneration == o.nGeneration); }
+	inline bool operator != (SConnectionHandle const& o) const { return !(*this == o); }
+};
+
+//
+//	Handle typed by the connection arguments, makes deferred invocation type safe
+//
+template <typename... TArguments>
+struct TConnectionHandle : SConnectionHandle
+{
+	inline TConnectionHandle() = default;
+	inline explicit TConnectionHandle(SConnectionHandle const& oHandle) : SConnectionHandle(oHandle) {}
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CHandleMap
+//	Slot map of connections, released slots are reused through the free list
+//	Not thread safe, should be used from the owning thread only
+//
+class CHandleMap
+{
+public:
+	inline CHandleMap() = default;
+	inline ~CHandleMap() = default;
+
+	CHandleMap(CHandleMap const&) = delete;
+	void operator=(CHandleMap const&) = delete;
+
+	// Map of the calling thread
+	inline static CHandleMap& ThreadDefault();
+
+public:
+	//
+	//	Methods
+	//
+
+	// Puts connection into the free slot and returns its handle
+	inline SConnectionHandle Register(CConnectionBase const& oCnctn);
+	// Releases the slot, all handles to it become stale, returns false if the handle already stale
+	inline bool Release(SConnectionHandle const& oHandle);
+	// Points the live handle to the relocated connection
+	inline bool Rebind(SConnectionHandle const& oHandle, CConnectionBase const& oCnctn);
+
+	// Returns the connection or nullptr if the handle is stale
+	inline CConnectionBase const* Resolve(SConnectionHandle const& oHandle) const;
+	inline bool IsAlive(SConnectionHandle const& oHandle) const;
+
+	// Invokes the connection if it is still alive, returns false if the handle is stale
+	template <typename TSender, typename... TArguments>
+	inline bool Invoke(TConnectionHandle<TArguments...> const& oHandle, TSender* pSender, TArguments... args) const;
+
+	// Returns number of live handles
+	inline size_t GetSize() const;
+
+private:
+	//
+	//	Implementation
+	//
+	struct SSlot
+	{
+		CConnectionBase const*	pCnctn = nullptr;
+		uint32_t				nGeneration = 1;
+		uint32_t				nNextFree = 0;
+	};
+	static constexpr uint32_t s_nNoSlot = UINT32_MAX;
+
+	//
+	//	Contents
+	//
+	std::vector<SSlot>	m_aSlots;
+	uint32_t			m_nFreeHead = s_nNoSlot;
+	size_t				m_nSize = 0;
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	THandleConnection
+//	Connection which registers itself in the handle map and releases its handle upon destruction
+//	Handle follows the connection when it is moved, moved from connection has the null handle
+//	Connection constructed with its owner rebinds the delegate to the moved owner, when it is embedded into it,
+//	connection constructed without the owner keeps its delegate when moved
+//
+template <typename... TArguments>
+class THandleConnection : public TConnection<TArguments...>
+{
+public:
+	//	Type definitions
+	using ConnectionType = TConnection<TArguments...>;
+	using DelegateType = typename ConnectionType::DelegateType;
+	using HandleType = TConnectionHandle<TArguments...>;
+
+	inline THandleConnection(CHandleMap& oMap = CHandleMap::ThreadDefault());
+	inline THandleConnection(DelegateType oDelegate, CHandleMap& oMap = CHandleMap::ThreadDefault());
+	// Connection embedded into oOwner, which is the target of the delegate
+	template <class TOwner>
+	inline THandleConnection(TOwner& oOwner, DelegateType oDelegate, CHandleMap& oMap = CHandleMap::ThreadDefault());
+	inline ~THandleConnection();
+
+	inline THandleConnection(THandleConnection&& other);
+	inline THandleConnection& operator=(THandleConnection&& other);
+
+	// Returns the handle for the deferred deliveries
+	inline HandleType GetHandle() const;
+	// Returns the map which issued the handle
+	inline CHandleMap& GetMap() const;
+
+private:
+	CHandleMap*		m_pMap;
+	HandleType		m_oHandle;
+	COwnerOffset	m_oOwner;	// Position of the connection in its owner
+};
+
+//
+//	Final handle connection definition for the external use
+//
+template <typename... TArguments>
+using HandleConnection = THandleConnection<TArguments...>;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CHandleMap Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline CHandleMap& CHandleMap::ThreadDefault()
+{
+	static thread_local CHandleMap s_oMap;
+	return s_oMap;
+}
+
+inline SConnectionHandle CHandleMap::Register(CConnectionBase const& oCnctn)
+{
+	uint32_t nIdx = m_nFreeHead;
+	if (nIdx != s_nNoSlot)
+		m_nFreeHead = m_aSlots[nIdx].nNextFree;
+	else
+	{
+		nIdx = static_cast<uint32_t>(m_aSlots.size());
+		m_aSlots.emplace_back();
+	}
+
+	SSlot& oSlot = m_aSlots[nIdx];
+	oSlot.pCnctn = &oCnctn;
+	++m_nSize;
+	return SConnectionHandle {nIdx, oSlot.nGeneration};
+}
+
+inline bool CHandleMap::Release(SConnectionHandle const& oHandle)
+{
+	if (!IsAlive(oHandle))
+		return false;
+
+	SSlot& oSlot = m_aSlots[oHandle.nIndex];
+	oSlot.pCnctn = nullptr;
+	// Zero generation is reserved for the null handle
+	if (++oSlot.nGeneration == 0)
+		oSlot.nGeneration = 1;
+	oSlot.nNextFree = m_nFreeHead;
+	m_nFreeHead = oHandle.nIndex;
+	--m_nSize;
+	return true;
+}
+
+inline bool CHandleMap::Rebind(SConnectionHandle const& oHandle, CConnectionBase const& oCnctn)
+{
+	if (!IsAlive(oHandle))
+		return false;
+
+	m_aSlots[oHandle.nIndex].pCnctn = &oCnctn;
+	return true;
+}
+
+inline CConnectionBase const* CHandleMap::Resolve(SConnectionHandle const& oHandle) const
+{
+	if (oHandle.nIndex >= m_aSlots.size())
+		return nullptr;
+
+	SSlot const& oSlot = m_aSlots[oHandle.nIndex];
+	return (oSlot.nGeneration == oHandle.nGeneration) ? oSlot.pCnctn : nullptr;
+}
+
+inline bool CHandleMap::IsAlive(SConnectionHandle const& oHandle) const
+{
+	return (Resolve(oHandle) != nullptr);
+}
+
+template <typename TSender, typename... TArguments>
+inline bool CHandleMap::Invoke(TConnectionHandle<TArguments...> const& oHandle, TSender* pSender, TArguments... args) const
+{
+	CConnectionBase const* pCnctn = Resolve(oHandle);
+	if (pCnctn == nullptr)
+		return false;
+
+	static_cast<TConnection<TArguments...> const*>(pCnctn)->Invoke(pSender, args...);
+	return true;
+}
+
+inline size_t CHandleMap::GetSize() const
+{
+	return m_nSize;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	THandleConnection Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename... TArguments>
+inline THandleConnection<TArguments...>::THandleConnection(CHandleMap& oMap) :
+	m_pMap(&oMap), m_oHandle(oMap.Register(*this))
+{
+}
+
+template <typename... TArguments>
+inline THandleConnection<TArguments...>::THandleConnection(DelegateType oDelegate, CHandleMap& oMap) :
+	ConnectionType(oDelegate), m_pMap(&oMap), m_oHandle(oMap.Register(*this))
+{
+}
+
+template <typename... TArguments>
+template <class TOwner>
+inline THandleConnection<TArguments...>::THandleConnection(TOwner& oOwner, DelegateType oDelegate, CHandleMap& oMap) :
+	ConnectionType(oDelegate), m_pMap(&oMap), m_oHandle(oMap.Register(*this))
+{
+	m_oOwner.Capture(this, &oOwner, sizeof(TOwner));
+}
+
+template <typename... TArguments>
+inline THandleConnection<TArguments...>::~THandleConnection()
+{
+	m_pMap->Release(m_oHandle);
+}
+
+template <typename... TArguments>
+inline THandleConnection<TArguments...>::THandleConnection(THandleConnection&& other) :
+	ConnectionType(std::move(other)), m_pMap(other.m_pMap), m_oHandle(other.m_oHandle), m_oOwner(other.m_oOwner)
+{
+	other.m_oHandle = HandleType();
+	m_pMap->Rebind(m_oHandle, *this);
+	ConnectionType::RebindTarget(m_oOwner.GetOwner(&other), m_oOwner.GetOwner(this));
+}
+
+template <typename... TArguments>
+inline THandleConnection<TArguments...>& THandleConnection<TArguments...>::operator=(THandleConnection&& other)
+{
+	if (this != &other)
+	{
+		ConnectionType::operator=(std::move(other));
+		m_pMap->Release(m_oHandle);
+		m_pMap = other.m_pMap;
+		m_oHandle = other.m_oHandle;
+		m_oOwner = other.m_oOwner;
+		other.m_oHandle = HandleType();
+		m_pMap->Rebind(m_oHandle, *this);
+		ConnectionType::RebindTarget(m_oOwner.GetOwner(&other), m_oOwner.GetOwner(this));
+	}
+	return *this;
+}
+
+template <typename... TArguments>
+inline typename THandleConnection<TArguments...>::HandleType THandleConnection<TArguments...>::GetHandle() const
+{
+	return m_oHandle;
+}
+
+template <typename... TArguments>
+inline CHandleMap& THandleConnection<TArguments...>::GetMap() const
+{
+	return *m_pMap;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_HANDLE_H
@@ -0,0 +1,562 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Per-listener latency histograms and slow listener watchdog
+//
+//	Profiled connection measures 1 of every N invocations of its listener made by a thread (every thread counts
+//	its own invocations, threads do not share a counter) and records the duration
+//	into the fixed size logarithmic histogram (HDR style, 8 sub-buckets per power of two, ~12% precision)
+//	Every profiled connection is registered in the process wide list under its receiver type and method name,
+//	watchdog periodically walks the list and reports listeners whose p99 latency exceeds the budget
+//	Regular connections are not affected and pay nothing
+//
+//	Usage example
+//
+/*
+	class CReceiver
+	{
+		TProfiledConnection<int> cnt_onChanged;
+		void OnChanged(int nValue);
+
+		CReceiver()
+			{cnt_onChanged.Init<CReceiver, &CReceiver::OnChanged>(*this, 16);}	// time 1 of 16 invocations
+	};
+
+	CLatencyWatchdog oWatchdog(std::chrono::microseconds(200), [](SLatencyReport const& oReport)
+		{log("slow listener %s p99=%lluns", oReport.szListener, oReport.nP99);});
+	oWatchdog.Start(std::chrono::seconds(1));
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_LATENCY_H
+#define NCD_LATENCY_H
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLatencyHistogram
+//	Lock-free histogram of durations in nanoseconds with logarithmic buckets
+//
+class CLatencyHistogram
+{
+public:
+	inline CLatencyHistogram();
+
+	CLatencyHistogram(CLatencyHistogram const&) = delete;
+	void operator=(CLatencyHistogram const&) = delete;
+
+	// Records single duration (could be called from any thread)
+	inline void Record(uint64_t nNanoseconds);
+	// Returns number of recorded durations
+	inline uint64_t GetCount() const;
+	// Returns upper bound of the bucket which contains specified percentile (0..100), zero if empty
+	inline uint64_t GetPercentile(double dPercentile) const;
+	// Clears all buckets
+	inline void Reset();
+
+	static constexpr uint32_t c_nSubBits = 3;
+	static constexpr uint32_t c_nSubBuckets = 1u << c_nSubBits;
+	static constexpr uint32_t c_nBuckets = (64 - c_nSubBits + 1) * c_nSubBuckets;
+
+	// Plain copy of the buckets, its percentiles agree with its count
+	struct SSnapshot
+	{
+		uint64_t	nCount = 0;
+		uint32_t	aBuckets[c_nBuckets] = {};
+
+		inline uint64_t GetPercentile(double dPercentile) const;
+	};
+	// Copies the buckets into the snapshot
+	inline void Load(SSnapshot& oSnapshot) const;
+	// Moves the buckets into the snapshot (bucket by bucket exchange), so durations recorded meanwhile are either
+	// in the snapshot or stay in the histogram, none is lost
+	inline void Drain(SSnapshot& oSnapshot);
+
+private:
+	//
+	//	Implementation
+	//
+
+	static inline uint32_t GetBucket(uint64_t nValue);
+	static inline uint64_t GetBucketUpperBound(uint32_t nBucket);
+
+private:
+	std::atomic<uint32_t>	m_aBuckets[c_nBuckets];
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLatencyProbe
+//	Signature independent part of the profiled connection: name, sampling and histogram
+//	Probes link themselves into the process wide registry which is walked by the watchdog
+//
+class CLatencyProbe
+{
+public:
+	inline CLatencyProbe();
+	inline ~CLatencyProbe();
+
+	CLatencyProbe(CLatencyProbe const&) = delete;
+	void operator=(CLatencyProbe const&) = delete;
+
+	// Receiver type and method of the listener
+	inline char const* GetName() const;
+	inline CLatencyHistogram& GetHistogram();
+	inline CLatencyHistogram const& GetHistogram() const;
+
+	// Calls fnVisitor(CLatencyProbe&) for every alive probe
+	template <typename TVisitor>
+	static inline void ForEach(TVisitor&& fnVisitor);
+
+protected:
+	// Returns true if current invocation should be measured, counts the invocations of the calling thread
+	// Thread keeps countdowns of the few probes it invoked last, evicted probe starts over with a measured invocation
+	inline bool IsSampled() const;
+
+	struct SCountdown
+	{
+		CLatencyProbe const*	pProbe = nullptr;
+		uint32_t				nLeft = 0;
+	};
+	static constexpr size_t c_nThreadCountdowns = 8;
+
+	struct SRegistry
+	{
+		std::mutex		oMutex;
+		CLatencyProbe*	pHead = nullptr;
+	};
+	static inline SRegistry& GetRegistry();
+
+protected:
+	char const*						m_szName = "";
+	uint32_t						m_nSampleEvery = 1;
+	mutable CLatencyHistogram		m_oHistogram;
+
+private:
+	CLatencyProbe*	m_pPrev = nullptr;
+	CLatencyProbe*	m_pNext = nullptr;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TProfiledConnection
+//	Connection which measures latency of its listener
+//
+template <typename... TArguments>
+class TProfiledConnection : public TConnection<TArguments...>, public CLatencyProbe
+{
+public:
+	using ConnectionType = TConnection<TArguments...>;
+	using DelegateType = typename ConnectionType::DelegateType;
+
+	inline TProfiledConnection() = default;
+
+	// Initializers, nSampleEvery = N measures 1 of every N invocations
+	template <class TReceiver, void(TReceiver::*TMethod)(TArguments...)>
+	inline void Init(TReceiver& oReceiver, uint32_t nSampleEvery = 1);
+	template <class TReceiver, void(TReceiver::*TMethod)(TArguments...) const>
+	inline void Init(TReceiver const& oReceiver, uint32_t nSampleEvery = 1);
+	template <typename TFunctor>
+	inline void Init(TFunctor const& fnListener, uint32_t nSampleEvery = 1);
+
+private:
+	//
+	//	Implementation
+	//
+	template <class TReceiver, void(TReceiver::*TMethod)(TArguments...)>
+	static inline char const* GetListenerName()
+		{return NCD_FUNCTION_SIGNATURE;}
+	template <class TReceiver, void(TReceiver::*TMethod)(TArguments...) const>
+	static inline char const* GetConstListenerName()
+		{return NCD_FUNCTION_SIGNATURE;}
+	template <typename TFunctor>
+	static inline char const* GetFunctorName()
+		{return NCD_FUNCTION_SIGNATURE;}
+
+	inline void Bind(DelegateType const& oTarget, char const* szName, uint32_t nSampleEvery);
+	inline void OnInvoke(void* pSender, TArguments... args) const;
+
+private:
+	DelegateType	m_oTarget;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLatencyWatchdog
+//	Reports listeners whose p99 latency exceeds the budget
+//	Each check covers the window since the previous check (examined histograms are drained)
+//
+struct SLatencyReport
+{
+	char const*	szListener;
+	uint64_t	nSamples;
+	uint64_t	nP50;		// nanoseconds
+	uint64_t	nP99;		// nanoseconds
+};
+
+class CLatencyWatchdog
+{
+public:
+	using ReportFunction = std::function<void(SLatencyReport const&)>;
+
+	inline CLatencyWatchdog(std::chrono::nanoseconds tBudget, ReportFunction fnReport, uint64_t nMinSamples = 16);
+	inline ~CLatencyWatchdog();
+
+	CLatencyWatchdog(CLatencyWatchdog const&) = delete;
+	void operator=(CLatencyWatchdog const&) = delete;
+
+	// Checks all profiled connections once, returns number of reported listeners
+	inline size_t Check();
+
+	// Starts/stops periodic checking on the background thread
+	inline void Start(std::chrono::nanoseconds tPeriod);
+	inline void Stop();
+
+private:
+	std::chrono::nanoseconds	m_tBudget;
+	ReportFunction				m_fnReport;
+	uint64_t					m_nMinSamples;
+
+	std::thread					m_oThread;
+	std::mutex					m_oMutex;
+	std::condition_variable		m_oStopped;
+	bool						m_bStop = false;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLatencyHistogram Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline CLatencyHistogram::CLatencyHistogram()
+{
+	Reset();
+}
+
+inline void CLatencyHistogram::Record(uint64_t nNanoseconds)
+{
+	m_aBuckets[GetBucket(nNanoseconds)].fetch_add(1, std::memory_order_relaxed);
+}
+
+inline uint64_t CLatencyHistogram::GetCount() const
+{
+	uint64_t nCount = 0;
+	for (auto const& nBucket : m_aBuckets)
+		nCount += nBucket.load(std::memory_order_relaxed);
+	return nCount;
+}
+
+inline uint64_t CLatencyHistogram::GetPercentile(double dPercentile) const
+{
+	SSnapshot oSnapshot;
+	Load(oSnapshot);
+	return oSnapshot.GetPercentile(dPercentile);
+}
+
+inline void CLatencyHistogram::Reset()
+{
+	for (auto& nBucket : m_aBuckets)
+		nBucket.store(0, std::memory_order_relaxed);
+}
+
+inline void CLatencyHistogram::Load(SSnapshot& oSnapshot) const
+{
+	oSnapshot.nCount = 0;
+	for (uint32_t i = 0; i < c_nBuckets; ++i)
+	{
+		oSnapshot.aBuckets[i] = m_aBuckets[i].load(std::memory_order_relaxed);
+		oSnapshot.nCount += oSnapshot.aBuckets[i];
+	}
+}
+
+inline void CLatencyHistogram::Drain(SSnapshot& oSnapshot)
+{
+	oSnapshot.nCount = 0;
+	for (uint32_t i = 0; i < c_nBuckets; ++i)
+	{
+		oSnapshot.aBuckets[i] = m_aBuckets[i].exchange(0, std::memory_order_relaxed);
+		oSnapshot.nCount += oSnapshot.aBuckets[i];
+	}
+}
+
+inline uint64_t CLatencyHistogram::SSnapshot::GetPercentile(double dPercentile) const
+{
+	if (nCount == 0)
+		return 0;
+
+	uint64_t nRank = static_cast<uint64_t>(dPercentile / 100.0 * static_cast<double>(nCount) + 0.5);
+	if (nRank == 0)
+		nRank = 1;
+	uint64_t nSeen = 0;
+	for (uint32_t i = 0; i < c_nBuckets; ++i)
+	{
+		nSeen += aBuckets[i];
+		if (nSeen >= nRank)
+			return GetBucketUpperBound(i);
+	}
+	return GetBucketUpperBound(c_nBuckets - 1);
+}
+
+inline uint32_t CLatencyHistogram::GetBucket(uint64_t nValue)
+{
+	if (nValue < c_nSubBuckets)
+		return static_cast<uint32_t>(nValue);
+
+	uint32_t nMsb = 0;
+	for (uint64_t v = nValue; v > 1; v >>= 1)
+		++nMsb;
+	uint32_t const nShift = nMsb - c_nSubBits;
+	return (nShift + 1) * c_nSubBuckets + static_cast<uint32_t>((nValue >> nShift) & (c_nSubBuckets - 1));
+}
+
+inline uint64_t CLatencyHistogram::GetBucketUpperBound(uint32_t nBucket)
+{
+	if (nBucket < c_nSubBuckets)
+		return nBucket;
+
+	uint32_t const nShift = nBucket / c_nSubBuckets - 1;
+	uint64_t const nSub = nBucket % c_nSubBuckets;
+	return ((c_nSubBuckets + nSub + 1) << nShift) - 1;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLatencyProbe Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline CLatencyProbe::CLatencyProbe()
+{
+	SRegistry& oRegistry = GetRegistry();
+	std::lock_guard<std::mutex> oLock(oRegistry.oMutex);
+	m_pNext = oRegistry.pHead;
+	if (m_pNext != nullptr)
+		m_pNext->m_pPrev = this;
+	oRegistry.pHead = this;
+}
+
+inline CLatencyProbe::~CLatencyProbe()
+{
+	SRegistry& oRegistry = GetRegistry();
+	std::lock_guard<std::mutex> oLock(oRegistry.oMutex);
+	if (m_pPrev != nullptr)
+		m_pPrev->m_pNext = m_pNext;
+	else
+		oRegistry.pHead = m_pNext;
+	if (m_pNext != nullptr)
+		m_pNext->m_pPrev = m_pPrev;
+}
+
+inline char const* CLatencyProbe::GetName() const
+{
+	return m_szName;
+}
+
+inline CLatencyHistogram& CLatencyProbe::GetHistogram()
+{
+	return m_oHistogram;
+}
+
+inline CLatencyHistogram const& CLatencyProbe::GetHistogram() const
+{
+	return m_oHistogram;
+}
+
+template <typename TVisitor>
+inline void CLatencyProbe::ForEach(TVisitor&& fnVisitor)
+{
+	SRegistry& oRegistry = GetRegistry();
+	std::lock_guard<std::mutex> oLock(oRegistry.oMutex);
+	for (CLatencyProbe* pProbe = oRegistry.pHead; pProbe != nullptr; pProbe = pProbe->m_pNext)
+		fnVisitor(*pProbe);
+}
+
+inline bool CLatencyProbe::IsSampled() const
+{
+	if (m_nSampleEvery == 1)
+		return true;
+
+	static thread_local SCountdown s_aCountdowns[c_nThreadCountdowns];
+	static thread_local size_t s_nVictim = 0;
+	SCountdown* pCountdown = nullptr;
+	for (SCountdown& oCountdown : s_aCountdowns)
+	{
+		if (oCountdown.pProbe == this)
+			pCountdown = &oCountdown;
+	}
+	if (pCountdown == nullptr)
+	{
+		pCountdown = &s_aCountdowns[s_nVictim];
+		s_nVictim = (s_nVictim + 1) % c_nThreadCountdowns;
+		*pCountdown = SCountdown {this, 0};
+	}
+
+	if (pCountdown->nLeft != 0)
+	{
+		--pCountdown->nLeft;
+		return false;
+	}
+	pCountdown->nLeft = m_nSampleEvery - 1;
+	return true;
+}
+
+inline CLatencyProbe::SRegistry& CLatencyProbe::GetRegistry()
+{
+	static SRegistry s_oRegistry;
+	return s_oRegistry;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TProfiledConnection Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename... TArguments>
+template <class TReceiver, void(TReceiver::*TMethod)(TArguments...)>
+inline void TProfiledConnection<TArguments...>::Init(TReceiver& oReceiver, uint32_t nSampleEvery)
+{
+	Bind(DelegateType::template Create<TReceiver, TMethod>(oReceiver),
+		 GetListenerName<TReceiver, TMethod>(), nSampleEvery);
+}
+
+template <typename... TArguments>
+template <class TReceiver, void(TReceiver::*TMethod)(TArguments...) const>
+inline void TProfiledConnection<TArguments...>::Init(TReceiver const& oReceiver, uint32_t nSampleEvery)
+{
+	Bind(DelegateType::template Create<TReceiver, TMethod>(oReceiver),
+		 GetConstListenerName<TReceiver, TMethod>(), nSampleEvery);
+}
+
+template <typename... TArguments>
+template <typename TFunctor>
+inline void TProfiledConnection<TArguments...>::Init(TFunctor const& fnListener, uint32_t nSampleEvery)
+{
+	Bind(DelegateType::template Create<TFunctor>(fnListener), GetFunctorName<TFunctor>(), nSampleEvery);
+}
+
+template <typename... TArguments>
+inline void TProfiledConnection<TArguments...>::Bind(DelegateType const& oTarget, char const* szName, uint32_t nSampleEvery)
+{
+	using Me = TProfiledConnection<TArguments...>;
+	m_oTarget = oTarget;
+	m_szName = szName;
+	m_nSampleEvery = (nSampleEvery != 0) ? nSampleEvery : 1;
+	m_oHistogram.Reset();
+	ConnectionType::Init(DelegateType::template CreateEx<void, Me, &Me::OnInvoke>(*this));
+}
+
+template <typename... TArguments>
+inline void TProfiledConnection<TArguments...>::OnInvoke(void* pSender, TArguments... args) const
+{
+	if (!IsSampled())
+	{
+		m_oTarget(pSender, args...);
+		return;
+	}
+
+	auto const tStart = std::chrono::steady_clock::now();
+	m_oTarget(pSender, args...);
+	auto const tElapsed = std::chrono::steady_clock::now() - tStart;
+	m_oHistogram.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(tElapsed).count()));
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLatencyWatchdog Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline CLatencyWatchdog::CLatencyWatchdog(std::chrono::nanoseconds tBudget, ReportFunction fnReport, uint64_t nMinSamples) :
+	m_tBudget(tBudget), m_fnReport(std::move(fnReport)), m_nMinSamples(nMinSamples)
+{
+}
+
+inline CLatencyWatchdog::~CLatencyWatchdog()
+{
+	Stop();
+}
+
+inline size_t CLatencyWatchdog::Check()
+{
+	size_t nReported = 0;
+	uint64_t const nBudget = static_cast<uint64_t>(m_tBudget.count());
+	CLatencyProbe::ForEach([&](CLatencyProbe& oProbe)
+	{
+		CLatencyHistogram& oHistogram = oProbe.GetHistogram();
+		if (oHistogram.GetCount() < m_nMinSamples)
+			return;
+
+		// Listeners keep recording while the window is taken, their durations go to this or the next window
+		CLatencyHistogram::SSnapshot oWindow;
+		oHistogram.Drain(oWindow);
+		SLatencyReport oReport {oProbe.GetName(), oWindow.nCount, oWindow.GetPercentile(50.0), oWindow.GetPercentile(99.0)};
+		if (oReport.nP99 > nBudget)
+		{
+			++nReported;
+			if (m_fnReport)
+				m_fnReport(oReport);
+		}
+	});
+	return nReported;
+}
+
+inline void CLatencyWatchdog::Start(std::chrono::nanoseconds tPeriod)
+{
+	Stop();
+	m_bStop = false;
+	m_oThread = std::thread([this, tPeriod]()
+	{
+		std::unique_lock<std::mutex> oLock(m_oMutex);
+		while (!m_oStopped.wait_for(oLock, tPeriod, [this]() {return m_bStop;}))
+		{
+			oLock.unlock();
+			Check();
+			oLock.lock();
+		}
+	});
+}
+
+inline void CLatencyWatchdog::Stop()
+{
+	if (!m_oThread.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> oLock(m_oMutex);
+		m_bStop = true;
+	}
+	m_oStopped.notify_all();
+	m_oThread.join();
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_LATENCY_H
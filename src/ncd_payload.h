@@ -0,0 +1,581 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Shared payloads (zero copy delivery of large arguments)
+//
+//	Payload is allocated from the pool, filled through the builder and becomes immutable once published
+//	Notification passes the payload by const reference: listeners get the view without touching the reference count,
+//	listeners which keep it for the deferred processing copy the payload, that only increments the reference count
+//	So one emission to N listeners costs a single (pooled) allocation and no copies of the value
+//	Reference counting policy is chosen by the delivery model:
+//		SLocalRefCount - plain counter, payload and pool are used from the one thread
+//		SAtomicRefCount - atomic counter and locked pool, payload could be released on any thread
+//	Pool should outlive all its payloads
+//
+//	Usage example
+//
+/*
+	class CDecoder
+	{
+	public:
+		Notification<CDecoder, Payload<SFrame> const&>	FrameDecoded;
+
+		void Decode(...)
+		{
+			auto oFrame = m_oPool.Allocate();			// mutable, owned exclusively
+			oFrame->aPixels.assign(...);
+			FrameDecoded.Notify(this, oFrame.Publish());	// immutable, shared from now on
+		}
+
+	private:
+		PayloadPool<SFrame>	m_oPool {8};
+	};
+
+	void CRecorder::onFrame(CDecoder*, Payload<SFrame> const& oFrame)
+	{
+		m_aQueue.push_back(oFrame);						// keeps the frame alive, no copy of the pixels
+	}
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_PAYLOAD_H
+#define NCD_PAYLOAD_H
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Reference counting policies
+//
+
+// Single threaded delivery: plain counter, pool is not locked
+struct SLocalRefCount
+{
+	struct SCounter
+	{
+		uint32_t nValue = 0;
+
+		inline void Set(uint32_t n) {nValue = n;}
+		inline uint32_t Get() const {return nValue;}
+		inline void Increment() {++nValue;}
+		// Returns true if the last reference released
+		inline bool Decrement() {return (--nValue == 0);}
+	};
+
+	struct SLock
+	{
+		inline void lock() {}
+		inline void unlock() {}
+	};
+};
+
+// Multi threaded delivery: atomic counter, pool is guarded by the mutex
+struct SAtomicRefCount
+{
+	struct SCounter
+	{
+		std::atomic<uint32_t> nValue {0};
+
+		inline void Set(uint32_t n) {nValue.store(n, std::memory_order_relaxed);}
+		inline uint32_t Get() const {return nValue.load(std::memory_order_relaxed);}
+		inline void Increment() {nValue.fetch_add(1, std::memory_order_relaxed);}
+		inline bool Decrement() {return (nValue.fetch_sub(1, std::memory_order_acq_rel) == 1);}
+	};
+
+	using SLock = std::mutex;
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename TValue, typename TRefPolicy>
+class TPayloadPool;
+
+template <typename TValue, typename TRefPolicy>
+class TPayloadBuilder;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TPayload
+//	Immutable reference counted view of the pooled value
+//
+template <typename TValue, typename TRefPolicy = SLocalRefCount>
+class TPayload
+{
+public:
+	using PoolType = TPayloadPool<TValue, TRefPolicy>;
+
+	inline TPayload() = default;
+	inline ~TPayload();
+
+	// Copy shares the value (increments the reference count)
+	inline TPayload(TPayload const& other);
+	inline TPayload& operator=(TPayload const& other);
+	inline TPayload(TPayload&& other);
+	inline TPayload& operator=(TPayload&& other);
+
+public:
+	//
+	//	Methods
+	//
+
+	// Returns true if payload refers no value
+	inline bool IsNull() const;
+	// Returns number of payloads sharing the value
+	inline uint32_t GetRefCount() const;
+	// Releases the value
+	inline void Reset();
+
+	inline TValue const& Get() const;
+	inline TValue const& operator* () const;
+	inline TValue const* operator-> () const;
+	inline explicit operator bool () const;
+
+private:
+	friend class TPayloadPool<TValue, TRefPolicy>;
+	friend class TPayloadBuilder<TValue, TRefPolicy>;
+
+	using BlockType = typename PoolType::SBlock;
+
+	inline explicit TPayload(BlockType* pBlock);
+
+private:
+	BlockType* m_pBlock = nullptr;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TPayloadBuilder
+//	Exclusive mutable access to the freshly allocated value, publishing turns it into the shared immutable payload
+//
+template <typename TValue, typename TRefPolicy = SLocalRefCount>
+class TPayloadBuilder
+{
+public:
+	using PoolType = TPayloadPool<TValue, TRefPolicy>;
+	using PayloadType = TPayload<TValue, TRefPolicy>;
+
+	inline TPayloadBuilder() = default;
+	inline ~TPayloadBuilder();
+
+	inline TPayloadBuilder(TPayloadBuilder&& other);
+	inline TPayloadBuilder& operator=(TPayloadBuilder&& other);
+
+	TPayloadBuilder(TPayloadBuilder const&) = delete;
+	void operator=(TPayloadBuilder const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	inline bool IsNull() const;
+	inline TValue& operator* () const;
+	inline TValue* operator-> () const;
+
+	// Publishes the value, builder becomes null
+	inline PayloadType Publish();
+
+private:
+	friend class TPayloadPool<TValue, TRefPolicy>;
+
+	using BlockType = typename PoolType::SBlock;
+
+	inline explicit TPayloadBuilder(BlockType* pBlock);
+
+private:
+	BlockType* m_pBlock = nullptr;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TPayloadPool
+//	Keeps released blocks in the free list and allocates new ones in chunks
+//
+template <typename TValue, typename TRefPolicy = SLocalRefCount>
+class TPayloadPool
+{
+public:
+	using PayloadType = TPayload<TValue, TRefPolicy>;
+	using BuilderType = TPayloadBuilder<TValue, TRefPolicy>;
+
+	inline TPayloadPool(size_t nReserve = 0);
+	inline ~TPayloadPool();
+
+	TPayloadPool(TPayloadPool const&) = delete;
+	void operator=(TPayloadPool const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Constructs the value in the free block and returns its builder
+	template <typename... TArgs>
+	inline BuilderType Allocate(TArgs&&... args);
+	// Constructs and publishes the value at once
+	template <typename... TArgs>
+	inline PayloadType Make(TArgs&&... args);
+
+	// Makes sure there are at least nCount free blocks
+	inline void Reserve(size_t nCount);
+	// Returns number of blocks allocated so far and number of them currently in use
+	inline size_t GetCapacity() const;
+	inline size_t GetUsed() const;
+
+private:
+	//
+	//	Implementation
+	//
+	struct SBlock
+	{
+		typename TRefPolicy::SCounter	oRefs;
+		TPayloadPool*					pPool = nullptr;
+		SBlock*							pNextFree = nullptr;
+		alignas(TValue) unsigned char	aStorage[sizeof(TValue)];
+
+		inline TValue* GetValue() {return std::launder(reinterpret_cast<TValue*>(aStorage));}
+	};
+
+	friend class TPayload<TValue, TRefPolicy>;
+	friend class TPayloadBuilder<TValue, TRefPolicy>;
+
+	inline void Grow(size_t nCount);
+	inline SBlock* Acquire();
+	// Destroys the value and returns its block into the free list
+	inline void Release(SBlock* pBlock);
+
+private:
+	//
+	//	Contents
+	//
+	mutable typename TRefPolicy::SLock		m_oLock;
+	std::vector<std::unique_ptr<SBlock[]>>	m_aChunks;
+	SBlock*									m_pFree = nullptr;
+	size_t									m_nCapacity = 0;
+	size_t									m_nUsed = 0;
+};
+
+//
+//	Final payload definitions for the external use
+//
+template <typename TValue>
+using Payload = TPayload<TValue, SLocalRefCount>;
+template <typename TValue>
+using PayloadPool = TPayloadPool<TValue, SLocalRefCount>;
+
+template <typename TValue>
+using SharedPayload = TPayload<TValue, SAtomicRefCount>;
+template <typename TValue>
+using SharedPayloadPool = TPayloadPool<TValue, SAtomicRefCount>;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TPayload Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename TValue, typename TRefPolicy>
+inline TPayload<TValue, TRefPolicy>::TPayload(BlockType* pBlock) :
+	m_pBlock(pBlock)
+{
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TPayload<TValue, TRefPolicy>::~TPayload()
+{
+	Reset();
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TPayload<TValue, TRefPolicy>::TPayload(TPayload const& other) :
+	m_pBlock(other.m_pBlock)
+{
+	if (m_pBlock != nullptr)
+		m_pBlock->oRefs.Increment();
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TPayload<TValue, TRefPolicy>& TPayload<TValue, TRefPolicy>::operator=(TPayload const& other)
+{
+	if (m_pBlock != other.m_pBlock)
+	{
+		if (other.m_pBlock != nullptr)
+			other.m_pBlock->oRefs.Increment();
+		Reset();
+		m_pBlock = other.m_pBlock;
+	}
+	return *this;
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TPayload<TValue, TRefPolicy>::TPayload(TPayload&& other) :
+	m_pBlock(other.m_pBlock)
+{
+	other.m_pBlock = nullptr;
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TPayload<TValue, TRefPolicy>& TPayload<TValue, TRefPolicy>::operator=(TPayload&& other)
+{
+	if (this != &other)
+	{
+		Reset();
+		m_pBlock = other.m_pBlock;
+		other.m_pBlock = nullptr;
+	}
+	return *this;
+}
+
+template <typename TValue, typename TRefPolicy>
+inline bool TPayload<TValue, TRefPolicy>::IsNull() const
+{
+	return (m_pBlock == nullptr);
+}
+
+template <typename TValue, typename TRefPolicy>
+inline uint32_t TPayload<TValue, TRefPolicy>::GetRefCount() const
+{
+	return (m_pBlock != nullptr) ? m_pBlock->oRefs.Get() : 0;
+}
+
+template <typename TValue, typename TRefPolicy>
+inline void TPayload<TValue, TRefPolicy>::Reset()
+{
+	if (m_pBlock != nullptr && m_pBlock->oRefs.Decrement())
+		m_pBlock->pPool->Release(m_pBlock);
+	m_pBlock = nullptr;
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TValue const& TPayload<TValue, TRefPolicy>::Get() const
+{
+	assert(m_pBlock != nullptr);
+	return *m_pBlock->GetValue();
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TValue const& TPayload<TValue, TRefPolicy>::operator* () const
+{
+	return Get();
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TValue const* TPayload<TValue, TRefPolicy>::operator-> () const
+{
+	return &Get();
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TPayload<TValue, TRefPolicy>::operator bool () const
+{
+	return (m_pBlock != nullptr);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TPayloadBuilder Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename TValue, typename TRefPolicy>
+inline TPayloadBuilder<TValue, TRefPolicy>::TPayloadBuilder(BlockType* pBlock) :
+	m_pBlock(pBlock)
+{
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TPayloadBuilder<TValue, TRefPolicy>::~TPayloadBuilder()
+{
+	// Not published value is dropped
+	if (m_pBlock != nullptr)
+		m_pBlock->pPool->Release(m_pBlock);
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TPayloadBuilder<TValue, TRefPolicy>::TPayloadBuilder(TPayloadBuilder&& other) :
+	m_pBlock(other.m_pBlock)
+{
+	other.m_pBlock = nullptr;
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TPayloadBuilder<TValue, TRefPolicy>& TPayloadBuilder<TValue, TRefPolicy>::operator=(TPayloadBuilder&& other)
+{
+	if (this != &other)
+	{
+		if (m_pBlock != nullptr)
+			m_pBlock->pPool->Release(m_pBlock);
+		m_pBlock = other.m_pBlock;
+		other.m_pBlock = nullptr;
+	}
+	return *this;
+}
+
+template <typename TValue, typename TRefPolicy>
+inline bool TPayloadBuilder<TValue, TRefPolicy>::IsNull() const
+{
+	return (m_pBlock == nullptr);
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TValue& TPayloadBuilder<TValue, TRefPolicy>::operator* () const
+{
+	assert(m_pBlock != nullptr);
+	return *m_pBlock->GetValue();
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TValue* TPayloadBuilder<TValue, TRefPolicy>::operator-> () const
+{
+	return &**this;
+}
+
+template <typename TValue, typename TRefPolicy>
+inline typename TPayloadBuilder<TValue, TRefPolicy>::PayloadType TPayloadBuilder<TValue, TRefPolicy>::Publish()
+{
+	BlockType* pBlock = m_pBlock;
+	m_pBlock = nullptr;
+	if (pBlock != nullptr)
+		pBlock->oRefs.Set(1);
+	return PayloadType(pBlock);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TPayloadPool Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename TValue, typename TRefPolicy>
+inline TPayloadPool<TValue, TRefPolicy>::TPayloadPool(size_t nReserve)
+{
+	if (nReserve > 0)
+		Grow(nReserve);
+}
+
+template <typename TValue, typename TRefPolicy>
+inline TPayloadPool<TValue, TRefPolicy>::~TPayloadPool()
+{
+	assert(m_nUsed == 0 && "Payload pool destroyed while its payloads are alive");
+}
+
+template <typename TValue, typename TRefPolicy>
+template <typename... TArgs>
+inline typename TPayloadPool<TValue, TRefPolicy>::BuilderType TPayloadPool<TValue, TRefPolicy>::Allocate(TArgs&&... args)
+{
+	SBlock* pBlock = Acquire();
+	try
+	{
+		::new (static_cast<void*>(pBlock->aStorage)) TValue(std::forward<TArgs>(args)...);
+	}
+	catch (...)
+	{
+		std::lock_guard<typename TRefPolicy::SLock> oGuard(m_oLock);
+		pBlock->pNextFree = m_pFree;
+		m_pFree = pBlock;
+		--m_nUsed;
+		throw;
+	}
+	return BuilderType(pBlock);
+}
+
+template <typename TValue, typename TRefPolicy>
+template <typename... TArgs>
+inline typename TPayloadPool<TValue, TRefPolicy>::PayloadType TPayloadPool<TValue, TRefPolicy>::Make(TArgs&&... args)
+{
+	return Allocate(std::forward<TArgs>(args)...).Publish();
+}
+
+template <typename TValue, typename TRefPolicy>
+inline void TPayloadPool<TValue, TRefPolicy>::Reserve(size_t nCount)
+{
+	std::lock_guard<typename TRefPolicy::SLock> oGuard(m_oLock);
+	size_t nFree = m_nCapacity - m_nUsed;
+	if (nFree < nCount)
+		Grow(nCount - nFree);
+}
+
+template <typename TValue, typename TRefPolicy>
+inline size_t TPayloadPool<TValue, TRefPolicy>::GetCapacity() const
+{
+	std::lock_guard<typename TRefPolicy::SLock> oGuard(m_oLock);
+	return m_nCapacity;
+}
+
+template <typename TValue, typename TRefPolicy>
+inline size_t TPayloadPool<TValue, TRefPolicy>::GetUsed() const
+{
+	std::lock_guard<typename TRefPolicy::SLock> oGuard(m_oLock);
+	return m_nUsed;
+}
+
+template <typename TValue, typename TRefPolicy>
+inline void TPayloadPool<TValue, TRefPolicy>::Grow(size_t nCount)
+{
+	std::unique_ptr<SBlock[]> pChunk(new SBlock[nCount]);
+	for (size_t i = 0; i < nCount; ++i)
+	{
+		pChunk[i].pPool = this;
+		pChunk[i].pNextFree = m_pFree;
+		m_pFree = &pChunk[i];
+	}
+	m_aChunks.push_back(std::move(pChunk));
+	m_nCapacity += nCount;
+}
+
+template <typename TValue, typename TRefPolicy>
+inline typename TPayloadPool<TValue, TRefPolicy>::SBlock* TPayloadPool<TValue, TRefPolicy>::Acquire()
+{
+	std::lock_guard<typename TRefPolicy::SLock> oGuard(m_oLock);
+	// Chunks grow geometrically, so the number of allocations is logarithmic
+	if (m_pFree == nullptr)
+		Grow(m_nCapacity > 0 ? m_nCapacity : 4);
+
+	SBlock* pBlock = m_pFree;
+	m_pFree = pBlock->pNextFree;
+	pBlock->pNextFree = nullptr;
+	++m_nUsed;
+	return pBlock;
+}
+
+template <typename TValue, typename TRefPolicy>
+inline void TPayloadPool<TValue, TRefPolicy>::Release(SBlock* pBlock)
+{
+	pBlock->GetValue()->~TValue();
+
+	std::lock_guard<typename TRefPolicy::SLock> oGuard(m_oLock);
+	pBlock->pNextFree = m_pFree;
+	m_pFree = pBlock;
+	--m_nUsed;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_PAYLOAD_H
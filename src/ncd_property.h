@@ -0,0 +1,288 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Property (value with change notification)
+//
+//	Keeps the value and emits its ntfChanged(old, new) only when assigned value differs from the current one
+//	Commit scope groups several assignments into the transaction: nothing is emitted inside the scope,
+//	when the outermost scope ends the notification is emitted at most once with the value before the transaction
+//	and the final value (and not emitted at all if the value has returned to the original one)
+//	Value type should be copyable (or movable if only moved in) and equality comparable,
+//	it need not be default constructible unless the property is constructed without the initial value
+//
+//	Usage example
+//
+/*
+	class CWindow
+	{
+	public:
+		Property<int, CWindow>	Width {*this, 640};
+		Property<int, CWindow>	Height {*this, 480};
+	};
+
+	oWindow.Width = 800;					// emits Width.ntfChanged(640, 800)
+	oWindow.Width = 800;					// nothing
+	{
+		auto oCommit = oWindow.Height.Commit();
+		oWindow.Height = 500;
+		oWindow.Height = 600;
+	}										// emits Height.ntfChanged(480, 600) once
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_PROPERTY_H
+#define NCD_PROPERTY_H
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+
+#include <optional>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TProperty
+//	Value which notifies its listeners about the real changes only
+//
+template <typename TValue, class TSender>
+class TProperty
+{
+public:
+	using NotificationType = TNotificationEX<TSender, TValue const&, TValue const&>;
+
+	inline TProperty(TSender& oSender, TValue tValue = TValue());
+	inline ~TProperty() = default;
+
+	TProperty(TProperty const&) = delete;
+	void operator=(TProperty const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Returns current value
+	inline TValue const& Get() const;
+	// Assigns new value, returns true if value has been changed
+	// Change is emitted immediately or at the end of the commit scope
+	inline bool Set(TValue const& tValue);
+	inline bool Set(TValue&& tValue);
+
+	///////////////////////////////////////////////////////////////////////////////
+	//
+	//	CCommit
+	//	Defers change notification till the end of the scope, scopes could be nested
+	//
+	class CCommit
+	{
+	public:
+		inline CCommit(TProperty& oProperty);
+		inline CCommit(CCommit&& o);
+		inline ~CCommit();
+
+		CCommit(CCommit const&) = delete;
+		void operator=(CCommit const&) = delete;
+		void operator=(CCommit&&) = delete;
+
+		// Ends the scope before the destruction
+		inline void Release();
+
+	private:
+		TProperty&	m_oProperty;
+		bool		m_bReleased;
+	};
+	///////////////////////////////////////////////////////////////////////////////
+
+	// Opens the commit scope
+	inline CCommit Commit();
+	// Returns true if there is an open commit scope
+	inline bool IsCommitting() const;
+
+public:
+	//
+	//	Operators
+	//
+	inline operator TValue const& () const;
+	inline TProperty& operator = (TValue const& tValue);
+	inline TProperty& operator = (TValue&& tValue);
+
+public:
+	//
+	//	Change notification: ntfChanged(TValue const& tOldValue, TValue const& tNewValue)
+	//
+	NotificationType ntfChanged;
+
+private:
+	//
+	//	Implementation
+	//
+	template <typename TNewValue>
+	inline bool Assign(TNewValue&& tValue);
+	inline void EndCommit();
+
+private:
+	//
+	//	Contents
+	//
+	TValue					m_tValue;
+	std::optional<TValue>	m_tCommitOld;			// Value before the first change made within the commit scope
+	uint32_t				m_nCommitDepth = 0;
+};
+
+//
+//	Final property definition for the external use
+//
+template <typename TValue, class TSender>
+using Property = TProperty<TValue, TSender>;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TProperty Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename TValue, class TSender>
+inline TProperty<TValue, TSender>::TProperty(TSender& oSender, TValue tValue) :
+	ntfChanged(oSender), m_tValue(std::move(tValue))
+{
+}
+
+template <typename TValue, class TSender>
+inline TValue const& TProperty<TValue, TSender>::Get() const
+{
+	return m_tValue;
+}
+
+template <typename TValue, class TSender>
+inline bool TProperty<TValue, TSender>::Set(TValue const& tValue)
+{
+	return Assign(tValue);
+}
+
+template <typename TValue, class TSender>
+inline bool TProperty<TValue, TSender>::Set(TValue&& tValue)
+{
+	return Assign(std::move(tValue));
+}
+
+template <typename TValue, class TSender>
+inline typename TProperty<TValue, TSender>::CCommit TProperty<TValue, TSender>::Commit()
+{
+	return CCommit(*this);
+}
+
+template <typename TValue, class TSender>
+inline bool TProperty<TValue, TSender>::IsCommitting() const
+{
+	return (m_nCommitDepth > 0);
+}
+
+template <typename TValue, class TSender>
+inline TProperty<TValue, TSender>::operator TValue const& () const
+{
+	return m_tValue;
+}
+
+template <typename TValue, class TSender>
+inline TProperty<TValue, TSender>& TProperty<TValue, TSender>::operator = (TValue const& tValue)
+{
+	Assign(tValue);
+	return *this;
+}
+
+template <typename TValue, class TSender>
+inline TProperty<TValue, TSender>& TProperty<TValue, TSender>::operator = (TValue&& tValue)
+{
+	Assign(std::move(tValue));
+	return *this;
+}
+
+template <typename TValue, class TSender>
+template <typename TNewValue>
+inline bool TProperty<TValue, TSender>::Assign(TNewValue&& tValue)
+{
+	if (m_tValue == tValue)
+		return false;
+
+	if (m_nCommitDepth > 0)
+	{
+		// Remember the value before the transaction, emit at the end of the scope
+		if (!m_tCommitOld)
+			m_tCommitOld.emplace(std::move(m_tValue));
+		m_tValue = std::forward<TNewValue>(tValue);
+	}
+	else
+	{
+		TValue tOld = std::move(m_tValue);
+		m_tValue = std::forward<TNewValue>(tValue);
+		ntfChanged.Notify(tOld, m_tValue);
+	}
+	return true;
+}
+
+template <typename TValue, class TSender>
+inline void TProperty<TValue, TSender>::EndCommit()
+{
+	if (--m_nCommitDepth > 0 || !m_tCommitOld)
+		return;
+
+	TValue tOld = std::move(*m_tCommitOld);
+	m_tCommitOld.reset();
+	// Transaction could return the value to the original one
+	if (!(tOld == m_tValue))
+		ntfChanged.Notify(tOld, m_tValue);
+}
+
+//
+//	CCommit
+//
+template <typename TValue, class TSender>
+inline TProperty<TValue, TSender>::CCommit::CCommit(TProperty& oProperty)
+	: m_oProperty(oProperty), m_bReleased(false)
+{
+	++m_oProperty.m_nCommitDepth;
+}
+
+template <typename TValue, class TSender>
+inline TProperty<TValue, TSender>::CCommit::CCommit(CCommit&& o)
+	: m_oProperty(o.m_oProperty), m_bReleased(o.m_bReleased)
+{
+	o.m_bReleased = true;
+}
+
+template <typename TValue, class TSender>
+inline TProperty<TValue, TSender>::CCommit::~CCommit()
+{
+	Release();
+}
+
+template <typename TValue, class TSender>
+inline void TProperty<TValue, TSender>::CCommit::Release()
+{
+	if (!m_bReleased)
+	{
+		m_bReleased = true;
+		m_oProperty.EndCommit();
+	}
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_PROPERTY_H
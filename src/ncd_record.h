@@ -0,0 +1,727 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Emission recording and replay
+//
+//	Recorder connections serialize every emission (notification ID, timestamp and arguments) into append-only
+//	memory-mapped log file. Every recording thread reserves a chunk of the log with single atomic operation and fills
+//	it without further synchronization, so any thread could record, threads do not contend for every record
+//	and recording makes no system calls. When the file capacity is exhausted further records are dropped and counted
+//	Replayer maps the log read-only, orders the records of all threads by their timestamps and re-fires
+//	registered notifications with recorded arguments (read in place), either keeping original time intervals
+//	or at maximum speed
+//	Recorded arguments should be trivially copyable, sender pointers are not recorded (replayer supplies them)
+//
+//	Usage example
+//
+/*
+	CEmissionRecorder oRecorder;
+	oRecorder.Open("session.ncdr", 256 << 20);
+	TRecorderConnection<int, double> cntRecPrice(oRecorder, 1);
+	cntRecPrice.Connect(oFeed.PriceChanged);
+		...
+	oRecorder.Close();
+
+	CEmissionReplayer oReplayer;
+	oReplayer.Open("session.ncdr");
+	oReplayer.Register(1, oFeed.PriceChanged, &oFeed);
+	oReplayer.Replay(CEmissionReplayer::ESpeed::Original);
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_RECORD_H
+#define NCD_RECORD_H
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CMappedFile
+//	Minimal memory-mapped file: created read-write with fixed size or opened read-only as a whole
+//
+class CMappedFile
+{
+public:
+	inline CMappedFile() = default;
+	inline ~CMappedFile();
+
+	CMappedFile(CMappedFile const&) = delete;
+	void operator=(CMappedFile const&) = delete;
+
+	// Creates (truncates) file of the specified size and maps it for writing
+	inline bool Create(char const* szPath, size_t nSize);
+	// Opens existing file and maps it for reading
+	inline bool Open(char const* szPath);
+	// Unmaps file, writable file is truncated to nKeepSize bytes if it is not zero
+	inline void Close(size_t nKeepSize = 0);
+
+	inline bool IsOpen() const	{return (m_pData != nullptr);}
+	inline uint8_t* GetData() const	{return m_pData;}
+	inline size_t GetSize() const	{return m_nSize;}
+
+private:
+	uint8_t*	m_pData = nullptr;
+	size_t		m_nSize = 0;
+	bool		m_bWritable = false;
+#if defined(_WIN32)
+	HANDLE		m_hFile = INVALID_HANDLE_VALUE;
+	HANDLE		m_hMapping = nullptr;
+#else
+	int			m_hFile = -1;
+#endif
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Log file layout
+//	Header is followed by the chunks, each one is filled with the records of a single thread
+//	Unused tail of the chunk stays zero filled (record size is zero)
+//
+struct SRecordFileHeader
+{
+	static constexpr uint32_t c_uMagic = 0x5244434E;	// 'NCDR'
+	static constexpr uint32_t c_uVersion = 2;
+
+	uint32_t				uMagic;
+	uint32_t				uVersion;
+	std::atomic<uint64_t>	nTail;			// Bytes reserved by the chunks after the header, never exceeds the capacity
+	uint64_t				nChunkSize;
+};
+
+struct SRecordHeader
+{
+	std::atomic<uint32_t>	uSize;			// Whole record size (8 byte aligned), non zero when record is complete
+	uint32_t				uNtfctnId;
+	uint64_t				nTimestamp;		// Nanoseconds since recorder opened
+};
+
+static_assert(sizeof(SRecordFileHeader) % 8 == 0 && sizeof(SRecordHeader) % 8 == 0, "Log headers should keep 8 byte alignment");
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CEmissionRecorder
+//	Writes emission records into the memory-mapped log, thread safe
+//
+class CEmissionRecorder
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	inline CEmissionRecorder() = default;
+	inline ~CEmissionRecorder();
+
+	CEmissionRecorder(CEmissionRecorder const&) = delete;
+	void operator=(CEmissionRecorder const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Creates log file with the specified capacity, returns false on failure
+	// Capacity is used in whole chunks (capacity smaller than the chunk makes a single chunk)
+	inline bool Open(char const* szPath, size_t nCapacity);
+	// Closes log file and truncates it to the recorded size, should not be called while recording
+	inline void Close();
+	inline bool IsOpen() const;
+
+	// Writes record into the chunk of the calling thread, returns false if recorder is closed or full
+	inline bool Write(uint32_t uNtfctnId, void const* pPayload, size_t nPayloadSize);
+	// Writes record with the specified arguments
+	template <typename... TArguments>
+	inline bool Record(uint32_t uNtfctnId, TArguments... args);
+
+	// Number of records dropped because log was full (or the record was larger than the chunk)
+	inline uint64_t GetDroppedCount() const;
+	// Number of bytes reserved by the recording threads (whole chunks)
+	inline uint64_t GetRecordedSize() const;
+
+	// Chunk reserved by the recording thread at once
+	static constexpr uint64_t c_nChunkSize = 64 * 1024;
+
+private:
+	//
+	//	Implementation
+	//
+	//	Chunk of the thread, recorders are told apart by the session taken upon Open
+	//	Thread keeps chunks of a few recorders, the one recording into more of them wastes the chunks it drops
+	struct SCursor
+	{
+		uint64_t	nSession = 0;
+		uint64_t	nNext = 0;
+		uint64_t	nEnd = 0;
+	};
+	static constexpr size_t c_nThreadCursors = 4;
+
+	// Returns the cursor of the calling thread with the space for the record, null if the log is full
+	inline SCursor* AcquireCursor(uint64_t nSize);
+
+private:
+	//
+	//	Contents
+	//
+	CMappedFile				m_oFile;
+	SRecordFileHeader*		m_pHeader = nullptr;
+	uint64_t				m_nCapacity = 0;
+	uint64_t				m_nChunkSize = 0;
+	uint64_t				m_nSession = 0;
+	Clock::time_point		m_tStart;
+	std::atomic<uint64_t>	m_nDropped {0};
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TRecorderConnection
+//	Connection which records emissions of the connected notifications under the specified ID
+//
+template <typename... TArguments>
+class TRecorderConnection : public TConnection<TArguments...>
+{
+	static_assert(std::is_trivially_copyable<TArgumentPack<TArguments...>>::value, "Recorded arguments should be trivially copyable");
+	static_assert(alignof(TArgumentPack<TArguments...>) <= 8, "Recorded arguments are read in place, they should not need more than 8 byte alignment");
+
+public:
+	using ConnectionType = TConnection<TArguments...>;
+	using DelegateType = typename ConnectionType::DelegateType;
+	using NotificationType = typename ConnectionType::NotificationType;
+
+	inline TRecorderConnection(CEmissionRecorder& oRecorder, uint32_t uNtfctnId);
+
+	TRecorderConnection(TRecorderConnection const&) = delete;
+	void operator=(TRecorderConnection const&) = delete;
+
+private:
+	inline void OnEmission(TArguments... args) const;
+
+	CEmissionRecorder&	m_oRecorder;
+	uint32_t const		m_uNtfctnId;
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CEmissionReplayer
+//	Re-fires recorded emissions on the registered notifications
+//
+class CEmissionReplayer
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	enum class ESpeed
+	{
+		Original,	// Keeps recorded intervals between emissions
+		Maximum		// Fires emissions back to back
+	};
+
+	inline CEmissionReplayer() = default;
+
+	CEmissionReplayer(CEmissionReplayer const&) = delete;
+	void operator=(CEmissionReplayer const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Maps log file, returns false if file could not be opened or has wrong format
+	inline bool Open(char const* szPath);
+	inline void Close();
+
+	// Binds records with specified ID to the notification and sender
+	template <class TSender, typename... TArguments>
+	inline void Register(uint32_t uNtfctnId, TNotification<TArguments...> const& oNtfctn, TSender* pSender);
+
+	// Replays whole log, returns number of fired emissions
+	// Records of unregistered IDs or with mismatching argument size are skipped
+	inline size_t Replay(ESpeed eSpeed = ESpeed::Maximum);
+
+private:
+	//
+	//	Implementation
+	//
+	using t_pfnFire = void(*)(void const* pNtfctn, void* pSender, uint8_t const* pPayload);
+
+	struct SRecordRef
+	{
+		uint64_t	nTimestamp;
+		uint64_t	nOffset;
+	};
+
+	struct SChannel
+	{
+		uint32_t	uNtfctnId;
+		size_t		nPayloadSize;
+		void const*	pNtfctn;
+		void*		pSender;
+		t_pfnFire	pfnFire;
+	};
+
+	template <class TSender, typename... TArguments>
+	static inline void Fire(void const* pNtfctn, void* pSender, uint8_t const* pPayload);
+
+	inline SChannel const* FindChannel(uint32_t uNtfctnId) const;
+
+private:
+	//
+	//	Contents
+	//
+	CMappedFile				m_oFile;
+	std::vector<SChannel>	m_aChannels;
+	std::vector<SRecordRef>	m_aRecords;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CMappedFile Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline CMappedFile::~CMappedFile()
+{
+	Close();
+}
+
+#if defined(_WIN32)
+inline bool CMappedFile::Create(char const* szPath, size_t nSize)
+{
+	Close();
+	m_hFile = ::CreateFileA(szPath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+							CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_hFile == INVALID_HANDLE_VALUE)
+		return false;
+	ULARGE_INTEGER uSize;
+	uSize.QuadPart = nSize;
+	m_hMapping = ::CreateFileMappingA(m_hFile, nullptr, PAGE_READWRITE, uSize.HighPart, uSize.LowPart, nullptr);
+	if (m_hMapping != nullptr)
+		m_pData = static_cast<uint8_t*>(::MapViewOfFile(m_hMapping, FILE_MAP_WRITE, 0, 0, nSize));
+	if (m_pData == nullptr)
+	{
+		Close();
+		return false;
+	}
+	m_nSize = nSize;
+	m_bWritable = true;
+	return true;
+}
+
+inline bool CMappedFile::Open(char const* szPath)
+{
+	Close();
+	m_hFile = ::CreateFileA(szPath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_hFile == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER nSize;
+	if (::GetFileSizeEx(m_hFile, &nSize) && nSize.QuadPart > 0)
+	{
+		m_hMapping = ::CreateFileMappingA(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_hMapping != nullptr)
+			m_pData = static_cast<uint8_t*>(::MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+	}
+	if (m_pData == nullptr)
+	{
+		Close();
+		return false;
+	}
+	m_nSize = static_cast<size_t>(nSize.QuadPart);
+	return true;
+}
+
+inline void CMappedFile::Close(size_t nKeepSize)
+{
+	if (m_pData != nullptr)
+		::UnmapViewOfFile(m_pData);
+	if (m_hMapping != nullptr)
+		::CloseHandle(m_hMapping);
+	if (m_hFile != INVALID_HANDLE_VALUE)
+	{
+		if (m_bWritable && nKeepSize != 0)
+		{
+			LARGE_INTEGER nPos;
+			nPos.QuadPart = static_cast<LONGLONG>(nKeepSize);
+			if (::SetFilePointerEx(m_hFile, nPos, nullptr, FILE_BEGIN))
+				::SetEndOfFile(m_hFile);
+		}
+		::CloseHandle(m_hFile);
+	}
+	m_pData = nullptr;
+	m_nSize = 0;
+	m_bWritable = false;
+	m_hMapping = nullptr;
+	m_hFile = INVALID_HANDLE_VALUE;
+}
+#else
+inline bool CMappedFile::Create(char const* szPath, size_t nSize)
+{
+	Close();
+	m_hFile = ::open(szPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (m_hFile < 0)
+		return false;
+	if (::ftruncate(m_hFile, static_cast<off_t>(nSize)) == 0)
+	{
+		void* pData = ::mmap(nullptr, nSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_hFile, 0);
+		if (pData != MAP_FAILED)
+			m_pData = static_cast<uint8_t*>(pData);
+	}
+	if (m_pData == nullptr)
+	{
+		Close();
+		return false;
+	}
+	m_nSize = nSize;
+	m_bWritable = true;
+	return true;
+}
+
+inline bool CMappedFile::Open(char const* szPath)
+{
+	Close();
+	m_hFile = ::open(szPath, O_RDONLY);
+	if (m_hFile < 0)
+		return false;
+	struct stat oStat;
+	if (::fstat(m_hFile, &oStat) == 0 && oStat.st_size > 0)
+	{
+		void* pData = ::mmap(nullptr, static_cast<size_t>(oStat.st_size), PROT_READ, MAP_SHARED, m_hFile, 0);
+		if (pData != MAP_FAILED)
+		{
+			m_pData = static_cast<uint8_t*>(pData);
+			m_nSize = static_cast<size_t>(oStat.st_size);
+		}
+	}
+	if (m_pData == nullptr)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+inline void CMappedFile::Close(size_t nKeepSize)
+{
+	if (m_pData != nullptr)
+		::munmap(m_pData, m_nSize);
+	if (m_hFile >= 0)
+	{
+		if (m_bWritable && nKeepSize != 0)
+			(void) ::ftruncate(m_hFile, static_cast<off_t>(nKeepSize));
+		::close(m_hFile);
+	}
+	m_pData = nullptr;
+	m_nSize = 0;
+	m_bWritable = false;
+	m_hFile = -1;
+}
+#endif
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CEmissionRecorder Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline CEmissionRecorder::~CEmissionRecorder()
+{
+	Close();
+}
+
+inline bool CEmissionRecorder::Open(char const* szPath, size_t nCapacity)
+{
+	Close();
+	if (!m_oFile.Create(szPath, sizeof(SRecordFileHeader) + nCapacity))
+		return false;
+
+	static std::atomic<uint64_t> s_nSessions {0};
+	m_nChunkSize = (std::min)(c_nChunkSize, uint64_t(nCapacity) & ~uint64_t(7));
+	m_nCapacity = (m_nChunkSize != 0) ? nCapacity / m_nChunkSize * m_nChunkSize : 0;
+	m_nSession = s_nSessions.fetch_add(1, std::memory_order_relaxed) + 1;
+
+	m_pHeader = new (m_oFile.GetData()) SRecordFileHeader;
+	m_pHeader->uMagic = SRecordFileHeader::c_uMagic;
+	m_pHeader->uVersion = SRecordFileHeader::c_uVersion;
+	m_pHeader->nTail.store(0, std::memory_order_relaxed);
+	m_pHeader->nChunkSize = m_nChunkSize;
+	m_nDropped.store(0, std::memory_order_relaxed);
+	m_tStart = Clock::now();
+	return true;
+}
+
+inline void CEmissionRecorder::Close()
+{
+	if (m_pHeader == nullptr)
+		return;
+	uint64_t const nUsed = m_pHeader->nTail.load(std::memory_order_acquire);
+	m_oFile.Close(static_cast<size_t>(sizeof(SRecordFileHeader) + nUsed));
+	m_pHeader = nullptr;
+	m_nCapacity = 0;
+}
+
+inline bool CEmissionRecorder::IsOpen() const
+{
+	return (m_pHeader != nullptr);
+}
+
+inline bool CEmissionRecorder::Write(uint32_t uNtfctnId, void const* pPayload, size_t nPayloadSize)
+{
+	if (m_pHeader == nullptr)
+		return false;
+
+	uint64_t const nSize = (sizeof(SRecordHeader) + nPayloadSize + 7) & ~uint64_t(7);
+	SCursor* pCursor = AcquireCursor(nSize);
+	if (pCursor == nullptr)
+	{
+		m_nDropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	uint64_t const nOffset = pCursor->nNext;
+	pCursor->nNext += nSize;
+
+	uint8_t* pRecord = m_oFile.GetData() + sizeof(SRecordFileHeader) + nOffset;
+	SRecordHeader* pHeader = new (pRecord) SRecordHeader;
+	pHeader->uNtfctnId = uNtfctnId;
+	pHeader->nTimestamp = static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_tStart).count());
+	if (nPayloadSize != 0)
+		std::memcpy(pRecord + sizeof(SRecordHeader), pPayload, nPayloadSize);
+	pHeader->uSize.store(static_cast<uint32_t>(nSize), std::memory_order_release);	// Commits the record
+	return true;
+}
+
+template <typename... TArguments>
+inline bool CEmissionRecorder::Record(uint32_t uNtfctnId, TArguments... args)
+{
+	TArgumentPack<TArguments...> oPack(args...);
+	return Write(uNtfctnId, &oPack, sizeof(oPack));
+}
+
+inline uint64_t CEmissionRecorder::GetDroppedCount() const
+{
+	return m_nDropped.load(std::memory_order_relaxed);
+}
+
+inline uint64_t CEmissionRecorder::GetRecordedSize() const
+{
+	return (m_pHeader != nullptr) ? m_pHeader->nTail.load(std::memory_order_relaxed) : 0;
+}
+
+inline CEmissionRecorder::SCursor* CEmissionRecorder::AcquireCursor(uint64_t nSize)
+{
+	static thread_local SCursor s_aCursors[c_nThreadCursors];
+	static thread_local size_t s_nVictim = 0;
+
+	SCursor* pCursor = nullptr;
+	for (SCursor& oCursor : s_aCursors)
+	{
+		if (oCursor.nSession == m_nSession)
+			pCursor = &oCursor;
+	}
+	if (pCursor == nullptr)
+	{
+		pCursor = &s_aCursors[s_nVictim];
+		s_nVictim = (s_nVictim + 1) % c_nThreadCursors;
+		*pCursor = SCursor {m_nSession, 0, 0};
+	}
+	if (pCursor->nEnd - pCursor->nNext >= nSize)
+		return pCursor;
+
+	// Reserves next chunk, the tail never goes beyond the capacity
+	if (nSize > m_nChunkSize)
+		return nullptr;
+	uint64_t nTail = m_pHeader->nTail.load(std::memory_order_relaxed);
+	do
+	{
+		if (nTail + m_nChunkSize > m_nCapacity)
+			return nullptr;
+	}
+	while (!m_pHeader->nTail.compare_exchange_weak(nTail, nTail + m_nChunkSize, std::memory_order_relaxed));
+	pCursor->nNext = nTail;
+	pCursor->nEnd = nTail + m_nChunkSize;
+	return pCursor;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TRecorderConnection Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename... TArguments>
+inline TRecorderConnection<TArguments...>::TRecorderConnection(CEmissionRecorder& oRecorder, uint32_t uNtfctnId) :
+	m_oRecorder(oRecorder), m_uNtfctnId(uNtfctnId)
+{
+	using Me = TRecorderConnection<TArguments...>;
+	ConnectionType::Init(DelegateType::template Create<Me, &Me::OnEmission>(*this));
+}
+
+template <typename... TArguments>
+inline void TRecorderConnection<TArguments...>::OnEmission(TArguments... args) const
+{
+	m_oRecorder.Record<TArguments...>(m_uNtfctnId, args...);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CEmissionReplayer Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline bool CEmissionReplayer::Open(char const* szPath)
+{
+	if (!m_oFile.Open(szPath))
+		return false;
+	SRecordFileHeader const* pHeader = reinterpret_cast<SRecordFileHeader const*>(m_oFile.GetData());
+	if (m_oFile.GetSize() < sizeof(SRecordFileHeader) ||
+		pHeader->uMagic != SRecordFileHeader::c_uMagic || pHeader->uVersion != SRecordFileHeader::c_uVersion ||
+		pHeader->nChunkSize == 0 || pHeader->nChunkSize % 8 != 0)
+	{
+		m_oFile.Close();
+		return false;
+	}
+	return true;
+}
+
+inline void CEmissionReplayer::Close()
+{
+	m_oFile.Close();
+	m_aRecords.clear();
+}
+
+template <class TSender, typename... TArguments>
+inline void CEmissionReplayer::Register(uint32_t uNtfctnId, TNotification<TArguments...> const& oNtfctn, TSender* pSender)
+{
+	static_assert(alignof(TArgumentPack<TArguments...>) <= 8, "Recorded arguments are read in place, they should not need more than 8 byte alignment");
+	SChannel oChannel {uNtfctnId, sizeof(TArgumentPack<TArguments...>), &oNtfctn, pSender, &Fire<TSender, TArguments...>};
+	for (SChannel& oExisting : m_aChannels)
+	{
+		if (oExisting.uNtfctnId == uNtfctnId)
+		{
+			oExisting = oChannel;
+			return;
+		}
+	}
+	m_aChannels.push_back(oChannel);
+}
+
+inline size_t CEmissionReplayer::Replay(ESpeed eSpeed)
+{
+	if (!m_oFile.IsOpen())
+		return 0;
+
+	SRecordFileHeader const* pFileHeader = reinterpret_cast<SRecordFileHeader const*>(m_oFile.GetData());
+	uint8_t const* pData = m_oFile.GetData() + sizeof(SRecordFileHeader);
+	uint64_t const nSize = (std::min)(pFileHeader->nTail.load(std::memory_order_acquire),
+									  uint64_t(m_oFile.GetSize() - sizeof(SRecordFileHeader)));
+	uint64_t const nChunkSize = pFileHeader->nChunkSize;
+
+	// Index the records chunk by chunk, every chunk ends with the first record which is not complete
+	m_aRecords.clear();
+	for (uint64_t nChunk = 0; nChunk < nSize; nChunk += nChunkSize)
+	{
+		uint64_t const nChunkEnd = (std::min)(nChunk + nChunkSize, nSize);
+		for (uint64_t nOffset = nChunk; nOffset + sizeof(SRecordHeader) <= nChunkEnd;)
+		{
+			SRecordHeader const* pRecord = reinterpret_cast<SRecordHeader const*>(pData + nOffset);
+			uint32_t const uRecordSize = pRecord->uSize.load(std::memory_order_acquire);
+			if (uRecordSize < sizeof(SRecordHeader) || nOffset + uRecordSize > nChunkEnd)
+				break;
+			m_aRecords.push_back(SRecordRef {pRecord->nTimestamp, nOffset});
+			nOffset += uRecordSize;
+		}
+	}
+	// Chunks of the threads interleave, a single recording thread leaves them already ordered
+	auto fnEarlier = [](SRecordRef const& oLeft, SRecordRef const& oRight) {return oLeft.nTimestamp < oRight.nTimestamp;};
+	if (!std::is_sorted(m_aRecords.begin(), m_aRecords.end(), fnEarlier))
+		std::stable_sort(m_aRecords.begin(), m_aRecords.end(), fnEarlier);
+
+	size_t nFired = 0;
+	Clock::time_point const tStart = Clock::now();
+	uint64_t nFirstStamp = 0;
+	bool bFirst = true;
+
+	for (SRecordRef const& oRef : m_aRecords)
+	{
+		SRecordHeader const* pRecord = reinterpret_cast<SRecordHeader const*>(pData + oRef.nOffset);
+		SChannel const* pChannel = FindChannel(pRecord->uNtfctnId);
+		if (pChannel != nullptr &&
+			((sizeof(SRecordHeader) + pChannel->nPayloadSize + 7) & ~size_t(7)) == pRecord->uSize.load(std::memory_order_relaxed))
+		{
+			if (eSpeed == ESpeed::Original)
+			{
+				if (bFirst)
+					nFirstStamp = oRef.nTimestamp;
+				std::this_thread::sleep_until(tStart + std::chrono::nanoseconds(oRef.nTimestamp - nFirstStamp));
+			}
+			bFirst = false;
+
+			pChannel->pfnFire(pChannel->pNtfctn, pChannel->pSender, pData + oRef.nOffset + sizeof(SRecordHeader));
+			++nFired;
+		}
+	}
+	return nFired;
+}
+
+template <class TSender, typename... TArguments>
+inline void CEmissionReplayer::Fire(void const* pNtfctn, void* pSender, uint8_t const* pPayload)
+{
+	// Payload is 8 byte aligned in the mapping, arguments are passed from there without copying the record
+	TArgumentPack<TArguments...> const& oPack = *reinterpret_cast<TArgumentPack<TArguments...> const*>(pPayload);
+	TNotification<TArguments...> const* pTarget = static_cast<TNotification<TArguments...> const*>(pNtfctn);
+	oPack.Apply([pTarget, pSender](auto const&... args)
+	{
+		pTarget->template Notify<TSender>(static_cast<TSender*>(pSender), args...);
+	});
+}
+
+inline CEmissionReplayer::SChannel const* CEmissionReplayer::FindChannel(uint32_t uNtfctnId) const
+{
+	for (SChannel const& oChannel : m_aChannels)
+	{
+		if (oChannel.uNtfctnId == uNtfctnId)
+			return &oChannel;
+	}
+	return nullptr;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_RECORD_H
@@ -0,0 +1,434 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Multicast ring notification (single producer - multiple consumers)
+//
+//	Each emission is written once into the pre-allocated ring (power of two size)
+//	Every consumer connection runs on its own thread with its own sequence cursor and processes ring in batches
+//	Producer never overruns the slowest consumer: it waits (according to the wait strategy) when the ring is full
+//	Arguments are stored by value, so they should be default constructible and copy assignable
+//
+//	Usage example
+//
+/*
+	RingNotification<CFeed, SQuote const&>	ntfQuote(4096);
+	TConnection<SQuote const&>				cntStrategy1(DelegateType::Create<...>(...));
+	TConnection<SQuote const&>				cntStrategy2(DelegateType::Create<...>(...));
+
+	ntfQuote.AddConsumer(cntStrategy1);
+	ntfQuote.AddConsumer(cntStrategy2);
+	ntfQuote.Start();
+		...
+	ntfQuote.Notify(this, oQuote);		// from the single producer thread
+		...
+	ntfQuote.Stop();					// drains published emissions and joins consumer threads
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_RING_H
+#define NCD_RING_H
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+#include "ncd_futex.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NCD_CPU_RELAX() _mm_pause()
+#else
+#define NCD_CPU_RELAX() std::this_thread::yield()
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Wait strategies
+//	WaitUntil blocks calling thread until the condition becomes true, Signal is called after every state change
+//
+
+// Lowest latency, burns the core while waiting
+class CBusySpinWait
+{
+public:
+	template <typename TCondition>
+	inline void WaitUntil(TCondition fnReady)
+	{
+		while (!fnReady())
+			NCD_CPU_RELAX();
+	}
+
+	inline void Signal() {}
+};
+
+// Gives the core to other threads while waiting
+class CYieldWait
+{
+public:
+	template <typename TCondition>
+	inline void WaitUntil(TCondition fnReady)
+	{
+		while (!fnReady())
+			std::this_thread::yield();
+	}
+
+	inline void Signal() {}
+};
+
+// Spins shortly then sleeps on the futex, signaling side enters the kernel only when there are sleepers
+class CBlockingWait
+{
+public:
+	template <typename TCondition>
+	inline void WaitUntil(TCondition fnReady)
+	{
+		for (unsigned nSpin = 0; nSpin < c_nSpinCount; ++nSpin)
+		{
+			if (fnReady())
+				return;
+			NCD_CPU_RELAX();
+		}
+
+		m_nWaiters.fetch_add(1, std::memory_order_seq_cst);
+		for (;;)
+		{
+			uint32_t uSeen = m_uSignal.load(std::memory_order_seq_cst);
+			if (fnReady())
+				break;
+			futex::Wait(m_uSignal, uSeen);
+		}
+		m_nWaiters.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	inline void Signal()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_nWaiters.load(std::memory_order_seq_cst) != 0)
+		{
+			m_uSignal.fetch_add(1, std::memory_order_seq_cst);
+			futex::WakeAll(m_uSignal);
+		}
+	}
+
+private:
+	static constexpr unsigned c_nSpinCount = 256;
+
+	std::atomic<uint32_t> m_uSignal {0};
+	std::atomic<uint32_t> m_nWaiters {0};
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TRingNotification
+//	Single producer multicast notification, delivers every emission to all consumers on their own threads
+//	Consumers could be added/removed only while the ring is stopped
+//	Emissions made while the ring is stopped are discarded
+//
+template <class TSender, class TWaitStrategy, typename... TArguments>
+class TRingNotification
+{
+	template <typename T>
+	using IsMutableRef = std::integral_constant<bool, std::is_lvalue_reference<T>::value &&
+												!std::is_const<std::remove_reference_t<T>>::value>;
+	static_assert(std::is_same<std::integer_sequence<bool, false, IsMutableRef<TArguments>::value...>,
+							   std::integer_sequence<bool, IsMutableRef<TArguments>::value..., false>>::value,
+				  "Ring notification could not deliver arguments by non-const reference");
+
+public:
+	using ConnectionType = TConnection<TArguments...>;
+	using DelegateType = typename ConnectionType::DelegateType;
+
+	//
+	//	Constructors
+	//
+	inline explicit TRingNotification(size_t nCapacity = 1024);
+	inline ~TRingNotification();
+
+	TRingNotification(TRingNotification const&) = delete;
+	void operator=(TRingNotification const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Ring size (power of two)
+	inline size_t GetCapacity() const;
+
+	// Adds consumer connection, returns false if ring is running or connection already added
+	inline bool AddConsumer(ConnectionType const& oCnctn);
+	// Removes consumer connection, returns false if ring is running or connection not found
+	inline bool RemoveConsumer(ConnectionType const& oCnctn);
+	inline size_t GetConsumerCount() const;
+
+	// Starts consumer threads, consumers start from the next emission
+	inline void Start();
+	// Delivers all published emissions and joins consumer threads
+	inline void Stop();
+	inline bool IsRunning() const;
+
+	// Publishes emission to the ring, should be called from the single producer thread
+	// Waits while the slowest consumer is a whole ring behind
+	inline void Notify(TSender* pSender, TArguments... args);
+	inline void operator() (TSender* pSender, TArguments... args);
+
+	//	Embedded connection to feed the ring from the regular Notification with same sender & argument types
+	ConnectionType cnt_Notify;
+
+private:
+	//
+	//	Implementation
+	//
+	struct SSlot
+	{
+		TSender* pSender = nullptr;
+		std::tuple<std::decay_t<TArguments>...> tArgs;
+	};
+
+	struct alignas(64) SConsumer
+	{
+		std::atomic<uint64_t>	nCursor {0};	// Number of consumed emissions
+		ConnectionType const*	pCnctn = nullptr;
+		std::thread				oThread;
+	};
+
+	inline void Consume(SConsumer& oConsumer);
+	inline uint64_t GetMinCursor() const;
+
+	template <size_t... tIdx>
+	static inline void Dispatch(ConnectionType const& oCnctn, SSlot const& oSlot, std::index_sequence<tIdx...>);
+
+private:
+	//
+	//	Contents
+	//
+	std::unique_ptr<SSlot[]>				m_aSlots;
+	uint64_t								m_nMask;
+	std::vector<std::unique_ptr<SConsumer>>	m_aConsumers;
+	bool									m_bRunning = false;
+	std::atomic<bool>						m_bStopping {false};
+
+	// Producer side, written only by the producer thread
+	alignas(64) uint64_t					m_nNext = 0;
+	uint64_t								m_nCachedGate = 0;
+	// Number of published emissions
+	alignas(64) std::atomic<uint64_t>		m_nPublished {0};
+
+	TWaitStrategy							m_oPublishWait;		// Consumers wait for publications
+	TWaitStrategy							m_oConsumeWait;		// Producer waits for the slowest consumer
+};
+
+//
+//	Final ring notification definition for the external use (blocking wait strategy)
+//
+template <class TSender, typename... TArguments>
+using RingNotification = TRingNotification<TSender, CBlockingWait, TArguments...>;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TRingNotification Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <class TSender, class TWaitStrategy, typename... TArguments>
+inline TRingNotification<TSender, TWaitStrategy, TArguments...>::TRingNotification(size_t nCapacity)
+{
+	size_t nSize = 2;
+	while (nSize < nCapacity)
+		nSize <<= 1;
+	m_aSlots.reset(new SSlot[nSize]);
+	m_nMask = nSize - 1;
+
+	using Me = TRingNotification<TSender, TWaitStrategy, TArguments...>;
+	cnt_Notify.Init(DelegateType::template CreateEx<TSender, Me, &Me::Notify>(*this));
+}
+
+template <class TSender, class TWaitStrategy, typename... TArguments>
+inline TRingNotification<TSender, TWaitStrategy, TArguments...>::~TRingNotification()
+{
+	Stop();
+}
+
+template <class TSender, class TWaitStrategy, typename... TArguments>
+inline size_t TRingNotification<TSender, TWaitStrategy, TArguments...>::GetCapacity() const
+{
+	return static_cast<size_t>(m_nMask + 1);
+}
+
+template <class TSender, class TWaitStrategy, typename... TArguments>
+inline bool TRingNotification<TSender, TWaitStrategy, TArguments...>::AddConsumer(ConnectionType const& oCnctn)
+{
+	if (m_bRunning)
+		return false;
+	for (auto const& pConsumer : m_aConsumers)
+	{
+		if (pConsumer->pCnctn == &oCnctn)
+			return false;
+	}
+	m_aConsumers.emplace_back(new SConsumer);
+	m_aConsumers.back()->pCnctn = &oCnctn;
+	return true;
+}
+
+template <class TSender, class TWaitStrategy, typename... TArguments>
+inline bool TRingNotification<TSender, TWaitStrategy, TArguments...>::RemoveConsumer(ConnectionType const& oCnctn)
+{
+	if (m_bRunning)
+		return false;
+	auto it = std::find_if(m_aConsumers.begin(), m_aConsumers.end(),
+						   [&oCnctn](std::unique_ptr<SConsumer> const& p) {return p->pCnctn == &oCnctn;});
+	if (it == m_aConsumers.end())
+		return false;
+	m_aConsumers.erase(it);
+	return true;
+}
+
+template <class TSender, class TWaitStrategy, typename... TArguments>
+inline size_t TRingNotification<TSender, TWaitStrategy, TArguments...>::GetConsumerCount() const
+{
+	return m_aConsumers.size();
+}
+
+template <class TSender, class TWaitStrategy, typename... TArguments>
+inline void TRingNotification<TSender, TWaitStrategy, TArguments...>::Start()
+{
+	if (m_bRunning)
+		return;
+	m_bRunning = true;
+	m_bStopping.store(false, std::memory_order_relaxed);
+	m_nCachedGate = m_nNext;
+	for (auto& pConsumer : m_aConsumers)
+	{
+		pConsumer->nCursor.store(m_nNext, std::memory_order_relaxed);
+		SConsumer& oConsumer = *pConsumer;
+		pConsumer->oThread = std::thread([this, &oConsumer]() {Consume(oConsumer);});
+	}
+}
+
+template <class TSender, class TWaitStrategy, typename... TArguments>
+inline void TRingNotification<TSender, TWaitStrategy, TArguments...>::Stop()
+{
+	if (!m_bRunning)
+		return;
+	m_bStopping.store(true, std::memory_order_release);
+	m_oPublishWait.Signal();
+	m_oConsumeWait.Signal();
+	for (auto& pConsumer : m_aConsumers)
+	{
+		if (pConsumer->oThread.joinable())
+			pConsumer->oThread.join();
+	}
+	m_bRunning = false;
+}
+
+template <class TSender, class TWaitStrategy, typename... TArguments>
+inline bool TRingNotification<TSender, TWaitStrategy, TArguments...>::IsRunning() const
+{
+	return m_bRunning;
+}
+
+template <class TSender, class TWaitStrategy, typename... TArguments>
+inline void TRingNotification<TSender, TWaitStrategy, TArguments...>::Notify(TSender* pSender, TArguments... args)
+{
+	if (!m_bRunning)
+		return;
+
+	uint64_t const nSeq = m_nNext;
+	uint64_t const nCapacity = m_nMask + 1;
+	if (nSeq - m_nCachedGate >= nCapacity)
+	{
+		// Ring is full according to the cached gate, wait for the slowest consumer
+		m_oConsumeWait.WaitUntil([this, nSeq, nCapacity]()
+		{
+			m_nCachedGate = GetMinCursor();
+			return (nSeq - m_nCachedGate < nCapacity);
+		});
+	}
+
+	SSlot& oSlot = m_aSlots[static_cast<size_t>(nSeq & m_nMask)];
+	oSlot.pSender = pSender;
+	oSlot.tArgs = std::tuple<std::decay_t<TArguments>...>(args...);
+
+	m_nNext = nSeq + 1;
+	m_nPublished.store(m_nNext, std::memory_order_release);
+	m_oPublishWait.Signal();
+}
+
+template <class TSender, class TWaitStrategy, typename... TArguments>
+inline void TRingNotification<TSender, TWaitStrategy, TArguments...>::operator() (TSender* pSender, TArguments... args)
+{
+	Notify(pSender, args...);
+}
+
+template <class TSender, class TWaitStrategy, typename... TArguments>
+inline void TRingNotification<TSender, TWaitStrategy, TArguments...>::Consume(SConsumer& oConsumer)
+{
+	uint64_t nNext = oConsumer.nCursor.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		uint64_t nAvailable = nNext;
+		bool bStopping = false;
+		m_oPublishWait.WaitUntil([this, nNext, &nAvailable, &bStopping]()
+		{
+			// Stop flag first: once it is seen the final published counter is visible too
+			bStopping = m_bStopping.load(std::memory_order_acquire);
+			nAvailable = m_nPublished.load(std::memory_order_acquire);
+			return (nAvailable > nNext || bStopping);
+		});
+
+		if (nAvailable == nNext)
+			break; // Stopping and drained
+
+		// Process the whole available batch then release it at once
+		for (; nNext < nAvailable; ++nNext)
+		{
+			SSlot const& oSlot = m_aSlots[static_cast<size_t>(nNext & m_nMask)];
+			Dispatch(*oConsumer.pCnctn, oSlot, std::index_sequence_for<TArguments...>());
+		}
+		oConsumer.nCursor.store(nNext, std::memory_order_release);
+		m_oConsumeWait.Signal();
+	}
+}
+
+template <class TSender, class TWaitStrategy, typename... TArguments>
+inline uint64_t TRingNotification<TSender, TWaitStrategy, TArguments...>::GetMinCursor() const
+{
+	uint64_t nMin = m_nNext;
+	for (auto const& pConsumer : m_aConsumers)
+		nMin = (std::min)(nMin, pConsumer->nCursor.load(std::memory_order_acquire));
+	return nMin;
+}
+
+template <class TSender, class TWaitStrategy, typename... TArguments>
+template <size_t... tIdx>
+inline void TRingNotification<TSender, TWaitStrategy, TArguments...>::Dispatch(
+	ConnectionType const& oCnctn, SSlot const& oSlot, std::index_sequence<tIdx...>)
+{
+	oCnctn.template Invoke<TSender>(oSlot.pSender, std::get<tIdx>(oSlot.tArgs)...);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_RING_H
@@ -0,0 +1,574 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Sharded notification (concurrent subscribe/unsubscribe/emit)
+//
+//	Subscriptions are kept in shards, every shard has its own lock and cache line isolated metadata
+//	Thread uses the shard of the core it runs on (sched_getcpu on Linux, GetCurrentProcessorNumber on Windows),
+//	elsewhere threads are assigned to the shards round robin upon their first use
+//	Thread subscribes and unsubscribes in its local shard only, so threads running on different cores do not contend
+//	Local shard is only a placement hint: thread could migrate at any moment, tokens and emissions remember their shard
+//	Notify goes through all shards without locks: slots are read under per-slot sequence numbers
+//	and never move (shard grows by blocks), emitting thread marks itself only in its local shard
+//	Unsubscribe does not wait for emissions in flight, Synchronize waits for them (grace period),
+//	so the receiver could be destroyed safely after Unsubscribe and Synchronize (CSubscription does both)
+//	Synchronize called from a handler could not wait for the emission it runs in, the wait is deferred
+//	until the emission of the calling thread ends (handler could release its own subscription)
+//	Subscribers are delegates (not connections), connection objects are bound to the single thread
+//
+//	Usage example
+//
+/*
+	ShardedNotification<CFeed, SQuote const&>	QuoteArrived;
+		...
+	// any thread
+	using DelegateType = decltype(QuoteArrived)::DelegateType;
+	auto oSubscription = QuoteArrived.Subscribe(DelegateType::Create<CWorker, &CWorker::onQuote>(*this));
+		...
+	// any thread
+	QuoteArrived.Notify(this, oQuote);
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_SHARDED_H
+#define NCD_SHARDED_H
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TShardedNotification
+//	Notification with sharded subscriber lists, shard per core
+//
+template <class TSender, typename... TArguments>
+class TShardedNotification
+{
+public:
+	//	Type definitions
+	using DelegateType = TDelegate<void(TArguments...)>;
+
+	//
+	//	Subscription token (slot of the shard and its sequence number at the time of subscription)
+	//
+	struct SToken
+	{
+		void*		pSlot = nullptr;
+		uint32_t	nShard = 0;
+		uint32_t	nSeq = 0;
+
+		inline bool IsNull() const {return (pSlot == nullptr);}
+	};
+
+	///////////////////////////////////////////////////////////////////////////////
+	//
+	//	CSubscription
+	//	Unsubscribes and waits for the emissions in flight upon destruction
+	//
+	class CSubscription
+	{
+	public:
+		inline CSubscription() = default;
+		inline CSubscription(TShardedNotification& oNtfctn, SToken const& oToken);
+		inline CSubscription(CSubscription&& other);
+		inline CSubscription& operator=(CSubscription&& other);
+		inline ~CSubscription();
+
+		CSubscription(CSubscription const&) = delete;
+		void operator=(CSubscription const&) = delete;
+
+		inline SToken const& GetToken() const;
+		// Unsubscribes and waits for the emissions in flight (handler releasing it waits after its emission)
+		inline void Release();
+
+	private:
+		TShardedNotification*	m_pNtfctn = nullptr;
+		SToken					m_oToken;
+	};
+	///////////////////////////////////////////////////////////////////////////////
+
+public:
+	// Number of shards is rounded up to the power of two, zero means number of hardware threads (shard per core)
+	inline TShardedNotification(uint32_t nShards = 0);
+	inline ~TShardedNotification();
+
+	TShardedNotification(TShardedNotification const&) = delete;
+	void operator=(TShardedNotification const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Subscribes delegate in the shard of the calling thread
+	inline SToken SubscribeToken(DelegateType const& oDelegate);
+	inline CSubscription Subscribe(DelegateType const& oDelegate);
+	// Removes subscription, returns false if it is already removed
+	// Emission in flight could still invoke the delegate, use Synchronize before destroying its target
+	inline bool Unsubscribe(SToken const& oToken);
+	// Waits until all emissions started before the call are finished
+	// Called during the emission, waits when the emission of the calling thread ends
+	inline void Synchronize() const;
+
+	// Invokes all subscribed delegates, could be called from any thread
+	// Subscriptions made or removed meanwhile may or may not be invoked
+	inline void Notify(TSender* pSender, TArguments... args) const NCD_EMIT_NOEXCEPT;
+	inline void operator() (TSender* pSender, TArguments... args) const NCD_EMIT_NOEXCEPT;
+
+	// Returns number of subscriptions (approximate while they are changing)
+	inline size_t GetCount() const;
+	inline uint32_t GetShardCount() const;
+
+private:
+	//
+	//	Implementation
+	//
+	static constexpr size_t c_nCacheLine = 64;
+	static constexpr uint32_t c_nBlockSlots = 32;
+	static constexpr size_t c_nDelegateWords = (sizeof(DelegateType) + sizeof(uintptr_t) - 1) / sizeof(uintptr_t);
+
+	// Delegate and the active flag are published under the sequence number (odd while being written)
+	struct SSlot
+	{
+		std::atomic<uint32_t>	nSeq {0};
+		std::atomic<bool>		bActive {false};
+		std::atomic<uintptr_t>	aDelegate[c_nDelegateWords] = {};	// Delegate copied word by word
+		SSlot*					pNextFree = nullptr;	// Guarded by the shard lock
+	};
+
+	struct SBlock
+	{
+		SSlot					aSlots[c_nBlockSlots];
+		std::atomic<SBlock*>	pNext {nullptr};
+	};
+
+	// Metadata written by different parties is kept in separate cache lines
+	struct alignas(c_nCacheLine) SShard
+	{
+		// Emissions in flight started by the threads of this shard, per grace period phase (local emitters)
+		std::atomic<uint32_t>	aReaders[2] = {};
+		// Subscriber list (written by the local subscribers, read by all emitters)
+		alignas(c_nCacheLine) std::atomic<uint32_t>	nCount {0};
+		std::atomic<uint32_t>	nUsed {0};			// Slots ever handed out, emission scans only them
+		std::atomic<SBlock*>	pFirst {nullptr};
+		// Allocation state (local subscribers only)
+		alignas(c_nCacheLine) std::mutex	oLock;
+		SBlock*					pLast = nullptr;
+		SSlot*					pFree = nullptr;
+	};
+
+	// Marks emission in the local shard for the grace period
+	// Scopes of the thread are stacked, so the thread knows the emissions it is running
+	class CReadScope
+	{
+	public:
+		inline CReadScope(TShardedNotification const& oNtfctn);
+		inline ~CReadScope();
+
+		CReadScope(CReadScope const&) = delete;
+		void operator=(CReadScope const&) = delete;
+
+		// Innermost emission of the calling thread
+		static inline CReadScope*& Top();
+
+	private:
+		TShardedNotification const&	m_oNtfctn;
+		std::atomic<uint32_t>&		m_nReaders;
+		CReadScope*					m_pOuter;
+		bool						m_bSyncDeferred = false;
+
+		friend class TShardedNotification;
+	};
+
+	inline uint32_t GetLocalShard() const;
+	// Returns index of the core running the calling thread or c_nUnknownCore if the system does not tell it
+	static inline uint32_t GetCurrentCore();
+	static constexpr uint32_t c_nUnknownCore = UINT32_MAX;
+	inline void WriteSlot(SSlot& oSlot, bool bActive, DelegateType const* pDelegate);
+	inline void WaitReaders(uint32_t nPhase) const;
+
+private:
+	//
+	//	Contents
+	//
+	std::unique_ptr<SShard[]>				m_aShards;
+	uint32_t								m_nShardMask = 0;
+	alignas(c_nCacheLine) mutable std::atomic<uint32_t>	m_nPhase {0};
+	mutable std::mutex						m_oSyncLock;
+};
+
+//
+//	Final sharded notification definition for the external use
+//
+template <class TSender, typename... TArguments>
+using ShardedNotification = TShardedNotification<TSender, TArguments...>;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TShardedNotification Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <class TSender, typename... TArguments>
+inline TShardedNotification<TSender, TArguments...>::TShardedNotification(uint32_t nShards)
+{
+	if (nShards == 0)
+		nShards = (std::max)(1u, std::thread::hardware_concurrency());
+	uint32_t nPow2 = 1;
+	while (nPow2 < nShards)
+		nPow2 <<= 1;
+
+	m_aShards.reset(new SShard[nPow2]);
+	m_nShardMask = nPow2 - 1;
+}
+
+template <class TSender, typename... TArguments>
+inline TShardedNotification<TSender, TArguments...>::~TShardedNotification()
+{
+	for (uint32_t i = 0; i <= m_nShardMask; ++i)
+	{
+		SBlock* pBlock = m_aShards[i].pFirst.load(std::memory_order_relaxed);
+		while (pBlock != nullptr)
+		{
+			SBlock* pNext = pBlock->pNext.load(std::memory_order_relaxed);
+			delete pBlock;
+			pBlock = pNext;
+		}
+	}
+}
+
+template <class TSender, typename... TArguments>
+inline uint32_t TShardedNotification<TSender, TArguments...>::GetLocalShard() const
+{
+	uint32_t const nCore = GetCurrentCore();
+	if (nCore != c_nUnknownCore)
+		return (nCore & m_nShardMask);
+
+	// Threads are spread over the shards round robin upon their first use
+	static std::atomic<uint32_t> s_nNextThread {0};
+	static thread_local uint32_t s_nThread = s_nNextThread.fetch_add(1, std::memory_order_relaxed);
+	return (s_nThread & m_nShardMask);
+}
+
+template <class TSender, typename... TArguments>
+inline uint32_t TShardedNotification<TSender, TArguments...>::GetCurrentCore()
+{
+#if defined(__linux__)
+	int const nCore = ::sched_getcpu();
+	return (nCore >= 0) ? static_cast<uint32_t>(nCore) : c_nUnknownCore;
+#elif defined(_WIN32)
+	return static_cast<uint32_t>(::GetCurrentProcessorNumber());
+#else
+	return c_nUnknownCore;
+#endif
+}
+
+template <class TSender, typename... TArguments>
+inline void TShardedNotification<TSender, TArguments...>::WriteSlot(SSlot& oSlot, bool bActive, DelegateType const* pDelegate)
+{
+	uint32_t nSeq = oSlot.nSeq.load(std::memory_order_relaxed);
+	oSlot.nSeq.store(nSeq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	oSlot.bActive.store(bActive, std::memory_order_relaxed);
+	if (pDelegate != nullptr)
+	{
+		uintptr_t aWords[c_nDelegateWords] = {};
+		std::memcpy(aWords, static_cast<void const*>(pDelegate), sizeof(DelegateType));
+		for (size_t i = 0; i < c_nDelegateWords; ++i)
+			oSlot.aDelegate[i].store(aWords[i], std::memory_order_relaxed);
+	}
+	// Release is enough, Synchronize orders the removals made before it against the emissions (see there)
+	oSlot.nSeq.store(nSeq + 2, std::memory_order_release);
+}
+
+template <class TSender, typename... TArguments>
+inline typename TShardedNotification<TSender, TArguments...>::SToken
+TShardedNotification<TSender, TArguments...>::SubscribeToken(DelegateType const& oDelegate)
+{
+	uint32_t const nShard = GetLocalShard();
+	SShard& oShard = m_aShards[nShard];
+	std::lock_guard<std::mutex> oGuard(oShard.oLock);
+
+	// Released slots are reused first (most recently released one), so the used prefix stays short
+	SSlot* pSlot = oShard.pFree;
+	if (pSlot != nullptr)
+	{
+		oShard.pFree = pSlot->pNextFree;
+		pSlot->pNextFree = nullptr;
+		WriteSlot(*pSlot, true, &oDelegate);
+	}
+	else
+	{
+		uint32_t const nUsed = oShard.nUsed.load(std::memory_order_relaxed);
+		if (nUsed % c_nBlockSlots == 0)
+		{
+			// Grow by the block, blocks never move and are released only with the notification
+			SBlock* pBlock = new SBlock;
+			if (oShard.pLast != nullptr)
+				oShard.pLast->pNext.store(pBlock, std::memory_order_release);
+			else
+				oShard.pFirst.store(pBlock, std::memory_order_release);
+			oShard.pLast = pBlock;
+		}
+		pSlot = &oShard.pLast->aSlots[nUsed % c_nBlockSlots];
+		WriteSlot(*pSlot, true, &oDelegate);
+		oShard.nUsed.store(nUsed + 1, std::memory_order_release);
+	}
+	// Count is written under the shard lock only
+	oShard.nCount.store(oShard.nCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+	SToken oToken;
+	oToken.pSlot = pSlot;
+	oToken.nShard = nShard;
+	oToken.nSeq = pSlot->nSeq.load(std::memory_order_relaxed);
+	return oToken;
+}
+
+template <class TSender, typename... TArguments>
+inline typename TShardedNotification<TSender, TArguments...>::CSubscription
+TShardedNotification<TSender, TArguments...>::Subscribe(DelegateType const& oDelegate)
+{
+	return CSubscription(*this, SubscribeToken(oDelegate));
+}
+
+template <class TSender, typename... TArguments>
+inline bool TShardedNotification<TSender, TArguments...>::Unsubscribe(SToken const& oToken)
+{
+	if (oToken.IsNull() || oToken.nShard > m_nShardMask)
+		return false;
+
+	SShard& oShard = m_aShards[oToken.nShard];
+	SSlot* pSlot = static_cast<SSlot*>(oToken.pSlot);
+	std::lock_guard<std::mutex> oGuard(oShard.oLock);
+	// Slot changed since the subscription: already removed (and maybe reused)
+	if (pSlot->nSeq.load(std::memory_order_relaxed) != oToken.nSeq)
+		return false;
+
+	WriteSlot(*pSlot, false, nullptr);
+	pSlot->pNextFree = oShard.pFree;
+	oShard.pFree = pSlot;
+	oShard.nCount.store(oShard.nCount.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+	return true;
+}
+
+template <class TSender, typename... TArguments>
+inline void TShardedNotification<TSender, TArguments...>::WaitReaders(uint32_t nPhase) const
+{
+	for (uint32_t i = 0; i <= m_nShardMask; ++i)
+	{
+		while (m_aShards[i].aReaders[nPhase].load(std::memory_order_seq_cst) != 0)
+			std::this_thread::yield();
+	}
+}
+
+template <class TSender, typename... TArguments>
+inline void TShardedNotification<TSender, TArguments...>::Synchronize() const
+{
+	// Two phase flips: emission which read the old phase but registered late is waited by the second flip
+	// Calling thread is emitting: waiting would never end, outermost emission of the thread waits instead
+	CReadScope* pOutermost = nullptr;
+	for (CReadScope* pScope = CReadScope::Top(); pScope != nullptr; pScope = pScope->m_pOuter)
+	{
+		if (&pScope->m_oNtfctn == this)
+			pOutermost = pScope;
+	}
+	if (pOutermost != nullptr)
+	{
+		pOutermost->m_bSyncDeferred = true;
+		return;
+	}
+
+	// Slot writes made before are ordered before the reader counts are checked, emission which registered
+	// after the check reads the written slots (its registration is sequentially consistent as well)
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	std::lock_guard<std::mutex> oGuard(m_oSyncLock);
+	for (int nFlip = 0; nFlip < 2; ++nFlip)
+	{
+		uint32_t nPhase = m_nPhase.load(std::memory_order_relaxed);
+		m_nPhase.store(nPhase ^ 1, std::memory_order_seq_cst);
+		WaitReaders(nPhase);
+	}
+}
+
+template <class TSender, typename... TArguments>
+inline void TShardedNotification<TSender, TArguments...>::Notify(TSender* pSender, TArguments... args) const NCD_EMIT_NOEXCEPT
+{
+	CReadScope oScope(*this);
+	for (uint32_t i = 0; i <= m_nShardMask; ++i)
+	{
+		SShard const& oShard = m_aShards[i];
+		if (oShard.nCount.load(std::memory_order_relaxed) == 0)
+			continue;
+
+		uint32_t nLeft = oShard.nUsed.load(std::memory_order_acquire);
+		for (SBlock* pBlock = oShard.pFirst.load(std::memory_order_acquire); pBlock != nullptr && nLeft > 0;
+			 pBlock = pBlock->pNext.load(std::memory_order_acquire))
+		{
+			uint32_t const nSlots = (std::min)(nLeft, c_nBlockSlots);
+			nLeft -= nSlots;
+			for (uint32_t nSlot = 0; nSlot < nSlots; ++nSlot)
+			{
+				SSlot& oSlot = pBlock->aSlots[nSlot];
+				uint32_t const nSeq = oSlot.nSeq.load(std::memory_order_acquire);
+				if ((nSeq & 1) != 0 || !oSlot.bActive.load(std::memory_order_relaxed))
+					continue;
+
+				uintptr_t aWords[c_nDelegateWords];
+				for (size_t w = 0; w < c_nDelegateWords; ++w)
+					aWords[w] = oSlot.aDelegate[w].load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				// Slot was rewritten while reading, subscription changed during the emission
+				if (oSlot.nSeq.load(std::memory_order_relaxed) != nSeq)
+					continue;
+
+				alignas(DelegateType) unsigned char aDelegate[sizeof(DelegateType)];
+				std::memcpy(aDelegate, aWords, sizeof(DelegateType));
+				(*reinterpret_cast<DelegateType const*>(aDelegate))(pSender, args...);
+			}
+		}
+	}
+}
+
+template <class TSender, typename... TArguments>
+inline void TShardedNotification<TSender, TArguments...>::operator() (TSender* pSender, TArguments... args) const NCD_EMIT_NOEXCEPT
+{
+	Notify(pSender, args...);
+}
+
+template <class TSender, typename... TArguments>
+inline size_t TShardedNotification<TSender, TArguments...>::GetCount() const
+{
+	size_t nCount = 0;
+	for (uint32_t i = 0; i <= m_nShardMask; ++i)
+		nCount += m_aShards[i].nCount.load(std::memory_order_relaxed);
+	return nCount;
+}
+
+template <class TSender, typename... TArguments>
+inline uint32_t TShardedNotification<TSender, TArguments...>::GetShardCount() const
+{
+	return m_nShardMask + 1;
+}
+
+//
+//	CReadScope
+//
+template <class TSender, typename... TArguments>
+inline TShardedNotification<TSender, TArguments...>::CReadScope::CReadScope(TShardedNotification const& oNtfctn) :
+	m_oNtfctn(oNtfctn),
+	m_nReaders(oNtfctn.m_aShards[oNtfctn.GetLocalShard()].aReaders[oNtfctn.m_nPhase.load(std::memory_order_seq_cst)]),
+	m_pOuter(Top())
+{
+	m_nReaders.fetch_add(1, std::memory_order_seq_cst);
+	Top() = this;
+}
+
+template <class TSender, typename... TArguments>
+inline TShardedNotification<TSender, TArguments...>::CReadScope::~CReadScope()
+{
+	Top() = m_pOuter;
+	m_nReaders.fetch_sub(1, std::memory_order_release);
+	// Grace period requested by the handlers of this emission
+	if (m_bSyncDeferred)
+		m_oNtfctn.Synchronize();
+}
+
+template <class TSender, typename... TArguments>
+inline typename TShardedNotification<TSender, TArguments...>::CReadScope*&
+TShardedNotification<TSender, TArguments...>::CReadScope::Top()
+{
+	static thread_local CReadScope* s_pTop = nullptr;
+	return s_pTop;
+}
+
+//
+//	CSubscription
+//
+template <class TSender, typename... TArguments>
+inline TShardedNotification<TSender, TArguments...>::CSubscription::CSubscription(TShardedNotification& oNtfctn, SToken const& oToken) :
+	m_pNtfctn(&oNtfctn), m_oToken(oToken)
+{
+}
+
+template <class TSender, typename... TArguments>
+inline TShardedNotification<TSender, TArguments...>::CSubscription::CSubscription(CSubscription&& other) :
+	m_pNtfctn(other.m_pNtfctn), m_oToken(other.m_oToken)
+{
+	other.m_pNtfctn = nullptr;
+	other.m_oToken = SToken();
+}
+
+template <class TSender, typename... TArguments>
+inline typename TShardedNotification<TSender, TArguments...>::CSubscription&
+TShardedNotification<TSender, TArguments...>::CSubscription::operator=(CSubscription&& other)
+{
+	if (this != &other)
+	{
+		Release();
+		m_pNtfctn = other.m_pNtfctn;
+		m_oToken = other.m_oToken;
+		other.m_pNtfctn = nullptr;
+		other.m_oToken = SToken();
+	}
+	return *this;
+}
+
+template <class TSender, typename... TArguments>
+inline TShardedNotification<TSender, TArguments...>::CSubscription::~CSubscription()
+{
+	Release();
+}
+
+template <class TSender, typename... TArguments>
+inline typename TShardedNotification<TSender, TArguments...>::SToken const&
+TShardedNotification<TSender, TArguments...>::CSubscription::GetToken() const
+{
+	return m_oToken;
+}
+
+template <class TSender, typename... TArguments>
+inline void TShardedNotification<TSender, TArguments...>::CSubscription::Release()
+{
+	if (m_pNtfctn != nullptr && m_pNtfctn->Unsubscribe(m_oToken))
+		m_pNtfctn->Synchronize();
+	m_pNtfctn = nullptr;
+	m_oToken = SToken();
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_SHARDED_H
@@ -0,0 +1,638 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Cross-process notifications over the shared memory ring (Linux)
+//
+//	Publisher connection copies emission arguments into the lock-free single producer / single consumer ring
+//	kept in the POSIX shared memory segment, receiver in the other process pumps the ring and re-emits
+//	arguments on its local notification with the same signature. Sides sleep on the process shared futexes
+//	and signal each other only when the other side sleeps. Sides register their process IDs in the segment,
+//	so a waiting side detects crashed peer instead of blocking forever
+//	Publisher does not stall the emitting thread by default: when the ring stays full for a short bounded spin
+//	the emission is dropped and counted, waiting for the receiver is opt-in (EShmFullPolicy::Block)
+//	Ring has a single producer: one publisher per segment, emitting from one thread at a time
+//	(debug build asserts against overlapping writes)
+//	Arguments should be trivially copyable, sender pointer is not transferred (receiver supplies its own)
+//
+//	Usage example
+//
+/*
+	// Process A
+	TShmPublisher<int, double> cntPublishPrice;
+	cntPublishPrice.Create("/prices", 4096);
+	cntPublishPrice.Connect(oFeed.PriceChanged);
+
+	// Process B
+	TShmReceiver<CFeedProxy, int, double> oPriceReceiver(oProxy.PriceChanged, &oProxy);
+	oPriceReceiver.Open("/prices");
+	while (oPriceReceiver.Pump(64, std::chrono::milliseconds(100)) != EShmStatus::PeerDead)
+		...
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_SHM_H
+#define NCD_SHM_H
+
+#if !defined(__linux__)
+#error "ncd_shm.h requires Linux (POSIX shared memory and process shared futexes)"
+#endif
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+#include "ncd_futex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+//
+//	Result of the shared memory operations
+//
+enum class EShmStatus
+{
+	Ok,			// Emissions delivered/published
+	Timeout,	// Nothing arrived during the timeout
+	PeerDead,	// Other side is not attached or its process has gone
+	NotOpen		// Segment is not opened
+};
+
+//
+//	What the publisher does when the ring is full
+//
+enum class EShmFullPolicy
+{
+	Drop,		// Spins for a bounded time, then drops the emission and counts it (default)
+	Block		// Waits until the receiver frees a slot or goes away, stalls the emitting thread meanwhile
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Shared segment layout
+//
+struct SShmRingHeader
+{
+	static constexpr uint32_t c_uMagic = 0x4D48534E;	// 'NSHM', written last by the creator
+	static constexpr uint32_t c_uVersion = 1;
+
+	std::atomic<uint32_t>	uMagic;
+	uint32_t				uVersion;
+	uint32_t				uSlotSize;
+	uint32_t				uArgCount;
+	uint64_t				nCapacity;			// Number of slots, power of two
+	std::atomic<int32_t>	nProducerPid;
+	std::atomic<int32_t>	nConsumerPid;
+
+	// Producer cursor and consumer wakeup
+	alignas(64) std::atomic<uint64_t>	nWritten;
+	std::atomic<uint32_t>				uWriteSignal;
+	std::atomic<uint32_t>				nConsumerWaiting;
+
+	// Consumer cursor and producer wakeup
+	alignas(64) std::atomic<uint64_t>	nRead;
+	std::atomic<uint32_t>				uReadSignal;
+	std::atomic<uint32_t>				nProducerWaiting;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CShmRing
+//	Signature independent part of the shared ring: segment management, cursors, waiting and peer tracking
+//
+class CShmRing
+{
+public:
+	inline CShmRing() = default;
+	inline ~CShmRing();
+
+	CShmRing(CShmRing const&) = delete;
+	void operator=(CShmRing const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Creates (replaces) segment as producer, slot count rounded up to power of two
+	inline bool Create(char const* szName, size_t nSlots, uint32_t uSlotSize, uint32_t uArgCount);
+	// Attaches to the existing segment as consumer, fails if segment has different slot layout
+	inline bool Open(char const* szName, uint32_t uSlotSize, uint32_t uArgCount);
+	// Detaches, creator also unlinks the segment name
+	inline void Close();
+	inline bool IsOpen() const;
+
+	// Producer: returns slot for the next write, null if consumer is gone or ring stays full
+	// Full ring is retried for a bounded spin, bBlock waits until consumer frees a slot instead
+	inline uint8_t* BeginWrite(bool bBlock);
+	inline void EndWrite();
+
+	// Consumer: waits for data, returns number of readable slots (starting from GetReadSlot(0))
+	inline EShmStatus WaitRead(size_t& nAvailable, std::chrono::nanoseconds tTimeout);
+	inline uint8_t const* GetReadSlot(size_t nIdx) const;
+	inline void EndRead(size_t nCount);
+
+	// Returns true if the process with specified ID is running
+	static inline bool IsProcessAlive(int32_t nPid);
+
+private:
+	//
+	//	Implementation
+	//
+	inline uint8_t* GetSlot(uint64_t nSeq) const;
+	// Waits until consumer frees a slot, returns false if it is gone
+	inline bool WaitWritable();
+
+	static constexpr std::chrono::milliseconds c_tPeerCheck {100};
+	static constexpr uint32_t c_nFullSpins = 256;
+
+private:
+	//
+	//	Contents
+	//
+	std::string			m_sName;
+	SShmRingHeader*		m_pHeader = nullptr;
+	size_t				m_nMappedSize = 0;
+	bool				m_bProducer = false;
+	uint64_t			m_nNext = 0;		// Local cursor (write for producer, read for consumer)
+	uint64_t			m_nCached = 0;		// Cached cursor of the other side
+#if !defined(NDEBUG)
+	std::atomic<bool>	m_bWriting {false};	// Detects overlapping writes (single producer violation)
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TShmPublisher
+//	Connection which publishes emissions of connected notifications into the shared ring
+//
+template <typename... TArguments>
+class TShmPublisher : public TConnection<TArguments...>
+{
+public:
+	using ConnectionType = TConnection<TArguments...>;
+	using DelegateType = typename ConnectionType::DelegateType;
+	using PackType = TArgumentPack<TArguments...>;
+	static_assert(std::is_trivially_copyable<PackType>::value, "Shared memory arguments should be trivially copyable");
+
+	inline TShmPublisher();
+
+	// Creates shared segment with the specified name and slot count
+	inline bool Create(char const* szName, size_t nSlots);
+	inline void Close();
+
+	// Sets what happens to the emission when the ring is full
+	inline void SetFullPolicy(EShmFullPolicy ePolicy);
+	inline EShmFullPolicy GetFullPolicy() const;
+
+	// Number of emissions dropped because receiver was absent or the ring was full
+	inline uint64_t GetDroppedCount() const;
+
+private:
+	inline void OnEmission(TArguments... args);
+
+	CShmRing		m_oRing;
+	EShmFullPolicy	m_ePolicy = EShmFullPolicy::Drop;
+	uint64_t		m_nDropped = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TShmReceiver
+//	Pumps the shared ring and re-emits received arguments on the local notification
+//
+template <class TSender, typename... TArguments>
+class TShmReceiver
+{
+public:
+	using NotificationType = TNotification<TArguments...>;
+	using PackType = TArgumentPack<TArguments...>;
+	static_assert(std::is_trivially_copyable<PackType>::value, "Shared memory arguments should be trivially copyable");
+
+	inline TShmReceiver(NotificationType const& oTarget, TSender* pSender);
+
+	TShmReceiver(TShmReceiver const&) = delete;
+	void operator=(TShmReceiver const&) = delete;
+
+	// Attaches to the shared segment created by the publisher
+	inline bool Open(char const* szName);
+	inline void Close();
+
+	// Waits up to tTimeout for emissions and re-emits at most nMaxBatch of them (zero: all available)
+	// If a listener throws, emissions re-emitted so far (including the failed one) are consumed anyway
+	inline EShmStatus Pump(size_t nMaxBatch, std::chrono::nanoseconds tTimeout);
+
+private:
+	NotificationType const&	m_oTarget;
+	TSender*				m_pSender;
+	CShmRing				m_oRing;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CShmRing Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline CShmRing::~CShmRing()
+{
+	Close();
+}
+
+inline bool CShmRing::Create(char const* szName, size_t nSlots, uint32_t uSlotSize, uint32_t uArgCount)
+{
+	Close();
+
+	uint64_t nCapacity = 2;
+	while (nCapacity < nSlots)
+		nCapacity <<= 1;
+	size_t const nSize = sizeof(SShmRingHeader) + static_cast<size_t>(nCapacity) * uSlotSize;
+
+	::shm_unlink(szName);
+	int hShm = ::shm_open(szName, O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (hShm < 0)
+		return false;
+	void* pData = MAP_FAILED;
+	if (::ftruncate(hShm, static_cast<off_t>(nSize)) == 0)
+		pData = ::mmap(nullptr, nSize, PROT_READ | PROT_WRITE, MAP_SHARED, hShm, 0);
+	::close(hShm);
+	if (pData == MAP_FAILED)
+	{
+		::shm_unlink(szName);
+		return false;
+	}
+
+	m_pHeader = new (pData) SShmRingHeader;
+	m_pHeader->uVersion = SShmRingHeader::c_uVersion;
+	m_pHeader->uSlotSize = uSlotSize;
+	m_pHeader->uArgCount = uArgCount;
+	m_pHeader->nCapacity = nCapacity;
+	m_pHeader->nProducerPid.store(static_cast<int32_t>(::getpid()), std::memory_order_relaxed);
+	m_pHeader->nConsumerPid.store(0, std::memory_order_relaxed);
+	m_pHeader->nWritten.store(0, std::memory_order_relaxed);
+	m_pHeader->uWriteSignal.store(0, std::memory_order_relaxed);
+	m_pHeader->nConsumerWaiting.store(0, std::memory_order_relaxed);
+	m_pHeader->nRead.store(0, std::memory_order_relaxed);
+	m_pHeader->uReadSignal.store(0, std::memory_order_relaxed);
+	m_pHeader->nProducerWaiting.store(0, std::memory_order_relaxed);
+	m_pHeader->uMagic.store(SShmRingHeader::c_uMagic, std::memory_order_release);
+
+	m_sName = szName;
+	m_nMappedSize = nSize;
+	m_bProducer = true;
+	m_nNext = 0;
+	m_nCached = 0;
+	return true;
+}
+
+inline bool CShmRing::Open(char const* szName, uint32_t uSlotSize, uint32_t uArgCount)
+{
+	Close();
+
+	int hShm = ::shm_open(szName, O_RDWR, 0600);
+	if (hShm < 0)
+		return false;
+	struct stat oStat;
+	void* pData = MAP_FAILED;
+	if (::fstat(hShm, &oStat) == 0 && static_cast<size_t>(oStat.st_size) >= sizeof(SShmRingHeader))
+		pData = ::mmap(nullptr, static_cast<size_t>(oStat.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, hShm, 0);
+	::close(hShm);
+	if (pData == MAP_FAILED)
+		return false;
+
+	SShmRingHeader* pHeader = static_cast<SShmRingHeader*>(pData);
+	size_t const nSize = static_cast<size_t>(oStat.st_size);
+	if (pHeader->uMagic.load(std::memory_order_acquire) != SShmRingHeader::c_uMagic ||
+		pHeader->uVersion != SShmRingHeader::c_uVersion ||
+		pHeader->uSlotSize != uSlotSize || pHeader->uArgCount != uArgCount ||
+		nSize < sizeof(SShmRingHeader) + pHeader->nCapacity * uSlotSize)
+	{
+		::munmap(pData, nSize);
+		return false;
+	}
+
+	m_pHeader = pHeader;
+	m_sName = szName;
+	m_nMappedSize = nSize;
+	m_bProducer = false;
+	m_nNext = m_pHeader->nRead.load(std::memory_order_acquire);
+	m_nCached = m_pHeader->nWritten.load(std::memory_order_acquire);
+	m_pHeader->nConsumerPid.store(static_cast<int32_t>(::getpid()), std::memory_order_release);
+	return true;
+}
+
+inline void CShmRing::Close()
+{
+	if (m_pHeader == nullptr)
+		return;
+
+	std::atomic<int32_t>& nMyPid = m_bProducer ? m_pHeader->nProducerPid : m_pHeader->nConsumerPid;
+	nMyPid.store(0, std::memory_order_release);
+	// Wake the peer so it notices our departure
+	m_pHeader->uWriteSignal.fetch_add(1, std::memory_order_seq_cst);
+	futex::WakeAll(m_pHeader->uWriteSignal, true);
+	m_pHeader->uReadSignal.fetch_add(1, std::memory_order_seq_cst);
+	futex::WakeAll(m_pHeader->uReadSignal, true);
+
+	::munmap(m_pHeader, m_nMappedSize);
+	if (m_bProducer)
+		::shm_unlink(m_sName.c_str());
+
+	m_pHeader = nullptr;
+	m_nMappedSize = 0;
+	m_sName.clear();
+}
+
+inline bool CShmRing::IsOpen() const
+{
+	return (m_pHeader != nullptr);
+}
+
+inline uint8_t* CShmRing::BeginWrite(bool bBlock)
+{
+#if !defined(NDEBUG)
+	bool const bOverlapped = m_bWriting.exchange(true, std::memory_order_acquire);
+	assert(!bOverlapped && "Shared ring has a single producer, the publisher should not be emitted concurrently");
+	(void) bOverlapped;
+#endif
+	uint64_t const nCapacity = m_pHeader->nCapacity;
+	if (m_nNext - m_nCached >= nCapacity)
+	{
+		m_nCached = m_pHeader->nRead.load(std::memory_order_acquire);
+		for (uint32_t nSpin = 0; nSpin < c_nFullSpins && m_nNext - m_nCached >= nCapacity; ++nSpin)
+		{
+			std::this_thread::yield();
+			m_nCached = m_pHeader->nRead.load(std::memory_order_acquire);
+		}
+		if (m_nNext - m_nCached >= nCapacity && (!bBlock || !WaitWritable()))
+		{
+#if !defined(NDEBUG)
+			m_bWriting.store(false, std::memory_order_release);
+#endif
+			return nullptr;
+		}
+	}
+	return GetSlot(m_nNext);
+}
+
+inline bool CShmRing::WaitWritable()
+{
+	uint64_t const nCapacity = m_pHeader->nCapacity;
+	while (m_nNext - m_nCached >= nCapacity)
+	{
+		if (!IsProcessAlive(m_pHeader->nConsumerPid.load(std::memory_order_acquire)))
+			return false;
+
+		m_pHeader->nProducerWaiting.store(1, std::memory_order_seq_cst);
+		uint32_t uSeen = m_pHeader->uReadSignal.load(std::memory_order_seq_cst);
+		m_nCached = m_pHeader->nRead.load(std::memory_order_seq_cst);
+		if (m_nNext - m_nCached >= nCapacity)
+			futex::Wait(m_pHeader->uReadSignal, uSeen, c_tPeerCheck, true);
+		m_pHeader->nProducerWaiting.store(0, std::memory_order_relaxed);
+		m_nCached = m_pHeader->nRead.load(std::memory_order_acquire);
+	}
+	return true;
+}
+
+inline void CShmRing::EndWrite()
+{
+#if !defined(NDEBUG)
+	m_bWriting.store(false, std::memory_order_release);
+#endif
+	m_pHeader->nWritten.store(++m_nNext, std::memory_order_release);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_pHeader->nConsumerWaiting.load(std::memory_order_seq_cst) != 0)
+	{
+		m_pHeader->uWriteSignal.fetch_add(1, std::memory_order_seq_cst);
+		futex::WakeOne(m_pHeader->uWriteSignal, true);
+	}
+}
+
+inline EShmStatus CShmRing::WaitRead(size_t& nAvailable, std::chrono::nanoseconds tTimeout)
+{
+	nAvailable = 0;
+	if (m_pHeader == nullptr)
+		return EShmStatus::NotOpen;
+
+	if (m_nCached == m_nNext)
+		m_nCached = m_pHeader->nWritten.load(std::memory_order_acquire);
+
+	auto const tDeadline = std::chrono::steady_clock::now() + tTimeout;
+	while (m_nCached == m_nNext)
+	{
+		if (!IsProcessAlive(m_pHeader->nProducerPid.load(std::memory_order_acquire)))
+		{
+			// Deliver whatever the dead producer managed to publish
+			m_nCached = m_pHeader->nWritten.load(std::memory_order_acquire);
+			if (m_nCached == m_nNext)
+				return EShmStatus::PeerDead;
+			break;
+		}
+
+		auto tLeft = tDeadline - std::chrono::steady_clock::now();
+		if (tLeft <= std::chrono::nanoseconds::zero())
+			return EShmStatus::Timeout;
+
+		m_pHeader->nConsumerWaiting.store(1, std::memory_order_seq_cst);
+		uint32_t uSeen = m_pHeader->uWriteSignal.load(std::memory_order_seq_cst);
+		m_nCached = m_pHeader->nWritten.load(std::memory_order_seq_cst);
+		if (m_nCached == m_nNext)
+		{
+			futex::Wait(m_pHeader->uWriteSignal, uSeen,
+						(std::min)(std::chrono::duration_cast<std::chrono::nanoseconds>(tLeft),
+								   std::chrono::nanoseconds(c_tPeerCheck)), true);
+		}
+		m_pHeader->nConsumerWaiting.store(0, std::memory_order_relaxed);
+		m_nCached = m_pHeader->nWritten.load(std::memory_order_acquire);
+	}
+
+	nAvailable = static_cast<size_t>(m_nCached - m_nNext);
+	return EShmStatus::Ok;
+}
+
+inline uint8_t const* CShmRing::GetReadSlot(size_t nIdx) const
+{
+	return GetSlot(m_nNext + nIdx);
+}
+
+inline void CShmRing::EndRead(size_t nCount)
+{
+	m_nNext += nCount;
+	m_pHeader->nRead.store(m_nNext, std::memory_order_release);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_pHeader->nProducerWaiting.load(std::memory_order_seq_cst) != 0)
+	{
+		m_pHeader->uReadSignal.fetch_add(1, std::memory_order_seq_cst);
+		futex::WakeOne(m_pHeader->uReadSignal, true);
+	}
+}
+
+inline bool CShmRing::IsProcessAlive(int32_t nPid)
+{
+	if (nPid <= 0 || (::kill(static_cast<pid_t>(nPid), 0) != 0 && errno != EPERM))
+		return false;
+
+	// Terminated but not yet reaped process (zombie) is dead for us
+	char szPath[32];
+	std::snprintf(szPath, sizeof(szPath), "/proc/%d/stat", static_cast<int>(nPid));
+	FILE* pFile = std::fopen(szPath, "r");
+	if (pFile == nullptr)
+		return true;
+	char chState = 0;
+	int nRead = std::fscanf(pFile, "%*d (%*[^)]) %c", &chState);
+	std::fclose(pFile);
+	return (nRead != 1 || (chState != 'Z' && chState != 'X'));
+}
+
+inline uint8_t* CShmRing::GetSlot(uint64_t nSeq) const
+{
+	uint8_t* pSlots = reinterpret_cast<uint8_t*>(m_pHeader) + sizeof(SShmRingHeader);
+	return pSlots + static_cast<size_t>(nSeq & (m_pHeader->nCapacity - 1)) * m_pHeader->uSlotSize;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TShmPublisher Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename... TArguments>
+inline TShmPublisher<TArguments...>::TShmPublisher()
+{
+	using Me = TShmPublisher<TArguments...>;
+	ConnectionType::Init(DelegateType::template Create<Me, &Me::OnEmission>(*this));
+}
+
+template <typename... TArguments>
+inline bool TShmPublisher<TArguments...>::Create(char const* szName, size_t nSlots)
+{
+	uint32_t const uSlotSize = static_cast<uint32_t>((sizeof(PackType) + 7) & ~size_t(7));
+	return m_oRing.Create(szName, nSlots, uSlotSize, static_cast<uint32_t>(sizeof...(TArguments)));
+}
+
+template <typename... TArguments>
+inline void TShmPublisher<TArguments...>::Close()
+{
+	m_oRing.Close();
+}
+
+template <typename... TArguments>
+inline void TShmPublisher<TArguments...>::SetFullPolicy(EShmFullPolicy ePolicy)
+{
+	m_ePolicy = ePolicy;
+}
+
+template <typename... TArguments>
+inline EShmFullPolicy TShmPublisher<TArguments...>::GetFullPolicy() const
+{
+	return m_ePolicy;
+}
+
+template <typename... TArguments>
+inline uint64_t TShmPublisher<TArguments...>::GetDroppedCount() const
+{
+	return m_nDropped;
+}
+
+template <typename... TArguments>
+inline void TShmPublisher<TArguments...>::OnEmission(TArguments... args)
+{
+	uint8_t* pSlot = m_oRing.IsOpen() ? m_oRing.BeginWrite(m_ePolicy == EShmFullPolicy::Block) : nullptr;
+	if (pSlot == nullptr)
+	{
+		++m_nDropped;
+		return;
+	}
+	PackType oPack(args...);
+	std::memcpy(pSlot, &oPack, sizeof(oPack));
+	m_oRing.EndWrite();
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TShmReceiver Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <class TSender, typename... TArguments>
+inline TShmReceiver<TSender, TArguments...>::TShmReceiver(NotificationType const& oTarget, TSender* pSender) :
+	m_oTarget(oTarget), m_pSender(pSender)
+{
+}
+
+template <class TSender, typename... TArguments>
+inline bool TShmReceiver<TSender, TArguments...>::Open(char const* szName)
+{
+	uint32_t const uSlotSize = static_cast<uint32_t>((sizeof(PackType) + 7) & ~size_t(7));
+	return m_oRing.Open(szName, uSlotSize, static_cast<uint32_t>(sizeof...(TArguments)));
+}
+
+template <class TSender, typename... TArguments>
+inline void TShmReceiver<TSender, TArguments...>::Close()
+{
+	m_oRing.Close();
+}
+
+template <class TSender, typename... TArguments>
+inline EShmStatus TShmReceiver<TSender, TArguments...>::Pump(size_t nMaxBatch, std::chrono::nanoseconds tTimeout)
+{
+	size_t nAvailable = 0;
+	EShmStatus eStatus = m_oRing.WaitRead(nAvailable, tTimeout);
+	if (eStatus != EShmStatus::Ok)
+		return eStatus;
+
+	// Slots are released on the way out, so a throwing listener does not get the same emissions again
+	struct SReadGuard
+	{
+		inline ~SReadGuard()
+			{oRing.EndRead(nConsumed);}
+
+		CShmRing&	oRing;
+		size_t		nConsumed;
+	};
+	SReadGuard oGuard {m_oRing, 0};
+
+	size_t const nCount = (nMaxBatch == 0) ? nAvailable : (std::min)(nAvailable, nMaxBatch);
+	for (size_t i = 0; i < nCount; ++i)
+	{
+		PackType oPack;
+		std::memcpy(&oPack, m_oRing.GetReadSlot(i), sizeof(oPack));
+		++oGuard.nConsumed;
+		oPack.Apply([this](auto&... args)
+		{
+			m_oTarget.template Notify<TSender>(m_pSender, args...);
+		});
+	}
+	return EShmStatus::Ok;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_SHM_H
@@ -0,0 +1,266 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Sticky notification (latest value cache)
+//
+//	Remembers the sender and arguments of the last emission under the seqlock
+//	Any thread could read the latest value without subscribing and without blocking the emitting side
+//	New connections are replayed with the latest value as soon as they are linked, however they connect
+//	The notification hooks itself (see CNotificationHook), so emissions made through the base notification
+//	or the chain are cached as well
+//	Arguments are stored by value, so they should be trivially copyable
+//	Notification should be emitted from one thread at a time (single writer)
+//
+//	Usage example
+//
+/*
+	StickyNotification<CSensor, double>	ntfTemperature;
+		...
+	ntfTemperature.Notify(this, 36.6);
+		...
+	std::tuple<double> tLatest;
+	if (ntfTemperature.GetLatest(tLatest))
+		...
+	cnt_onTemperature.Connect(ntfTemperature);	// invoked at once with 36.6
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_STICKY_H
+#define NCD_STICKY_H
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+
+#include <atomic>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TSeqLockValue
+//	Single writer / multiple readers value, readers never block the writer and retry if they overlapped with the write
+//
+template <typename TValue>
+class TSeqLockValue
+{
+	static_assert(std::is_trivially_copyable<TValue>::value, "SeqLock value should be trivially copyable");
+
+public:
+	inline TSeqLockValue() = default;
+
+	TSeqLockValue(TSeqLockValue const&) = delete;
+	void operator=(TSeqLockValue const&) = delete;
+
+	// Stores new value (single writer)
+	inline void Store(TValue const& tValue);
+	// Loads consistent snapshot of the value
+	inline TValue Load() const;
+	// Returns number of stores made so far
+	inline uint32_t GetVersion() const;
+
+private:
+	std::atomic<uint32_t>	m_uSequence {0};
+	TValue					m_tValue {};
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TStickyNotificationX
+//	Notification which keeps the latest emitted value
+//	Value is stored upon every emission, even if notification is blocked
+//	Latest value is kept for the readers, so unlike the plain notification NotifyLazy always calls the producer
+//
+template <class TSender, typename... TArguments>
+class TStickyNotificationX : public TNotificationX<TSender, TArguments...>, private TNotificationHook<TArguments...>
+{
+public:
+	using Base = TNotificationX<TSender, TArguments...>;
+	using NotificationType = typename Base::NotificationType;
+	using ConnectionType = typename Base::ConnectionType;
+	using ValueType = std::tuple<std::decay_t<TArguments>...>;
+
+	inline TStickyNotificationX();
+	inline ~TStickyNotificationX() = default;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Returns true if notification was emitted at least once since construction or last reset
+	inline bool HasLatest() const;
+	// Copies the latest value into the tValue (and its sender into the ppSender), returns false if there is no value
+	// Could be called from any thread
+	inline bool GetLatest(ValueType& tValue, TSender** ppSender = nullptr) const;
+	// Forgets the latest value
+	inline void ResetLatest() const;
+
+	// Invokes specified connection with the latest value if there is one
+	inline void Replay(ConnectionType const& oCnctn) const;
+
+	// Adds specified connection, the latest value is replayed to it unless bReplay is false
+	using NotificationType::AddConnection;
+	inline void AddConnection(ConnectionType const& oCnctn, bool bReplay) const;
+
+private:
+	//
+	//	Implementation
+	//
+	// Caches the emission
+	inline void OnEmit(void* pSender, TArguments... args) const override;
+	// Replays the latest value to the new connection
+	inline void OnLinked(CConnectionBase const& oCnctn) const override;
+	using PackType = TArgumentPack<TArguments...>;
+	static_assert(std::is_trivially_copyable<PackType>::value, "Sticky notification arguments should be trivially copyable");
+
+	struct SLatest
+	{
+		TSender*	pSender;
+		PackType	oArgs;
+		bool		bValid;
+	};
+
+private:
+	//
+	//	Contents
+	//
+	mutable TSeqLockValue<SLatest> m_oLatest;
+	// Cleared while the connection is added without replay
+	mutable bool m_bReplayOnLink = true;
+};
+
+//
+//	Final sticky notification definition for the external use
+//
+template <class TSender, typename... TArguments>
+using StickyNotification = TStickyNotificationX<TSender, TArguments...>;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TSeqLockValue Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename TValue>
+inline void TSeqLockValue<TValue>::Store(TValue const& tValue)
+{
+	uint32_t uSeq = m_uSequence.load(std::memory_order_relaxed);
+	m_uSequence.store(uSeq + 1, std::memory_order_relaxed);		// odd - write in progress
+	std::atomic_thread_fence(std::memory_order_release);
+	std::memcpy(&m_tValue, &tValue, sizeof(TValue));
+	m_uSequence.store(uSeq + 2, std::memory_order_release);		// even - stable
+}
+
+template <typename TValue>
+inline TValue TSeqLockValue<TValue>::Load() const
+{
+	TValue tValue;
+	for (;;)
+	{
+		uint32_t uBefore = m_uSequence.load(std::memory_order_acquire);
+		if ((uBefore & 1) == 0)
+		{
+			std::memcpy(&tValue, &m_tValue, sizeof(TValue));
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (m_uSequence.load(std::memory_order_relaxed) == uBefore)
+				break;
+		}
+	}
+	return tValue;
+}
+
+template <typename TValue>
+inline uint32_t TSeqLockValue<TValue>::GetVersion() const
+{
+	return m_uSequence.load(std::memory_order_acquire) / 2;
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TStickyNotificationX Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <class TSender, typename... TArguments>
+inline TStickyNotificationX<TSender, TArguments...>::TStickyNotificationX()
+{
+	m_oLatest.Store(SLatest {nullptr, PackType(), false});
+	NotificationType::SetHook(this);
+}
+
+template <class TSender, typename... TArguments>
+inline bool TStickyNotificationX<TSender, TArguments...>::HasLatest() const
+{
+	return m_oLatest.Load().bValid;
+}
+
+template <class TSender, typename... TArguments>
+inline bool TStickyNotificationX<TSender, TArguments...>::GetLatest(ValueType& tValue, TSender** ppSender) const
+{
+	SLatest oLatest = m_oLatest.Load();
+	if (oLatest.bValid)
+	{
+		tValue = oLatest.oArgs.ToTuple();
+		if (ppSender != nullptr)
+			*ppSender = oLatest.pSender;
+	}
+	return oLatest.bValid;
+}
+
+template <class TSender, typename... TArguments>
+inline void TStickyNotificationX<TSender, TArguments...>::ResetLatest() const
+{
+	m_oLatest.Store(SLatest {nullptr, PackType(), false});
+}
+
+template <class TSender, typename... TArguments>
+inline void TStickyNotificationX<TSender, TArguments...>::Replay(ConnectionType const& oCnctn) const
+{
+	SLatest oLatest = m_oLatest.Load();
+	if (oLatest.bValid)
+		oLatest.oArgs.Invoke(oCnctn, oLatest.pSender);
+}
+
+template <class TSender, typename... TArguments>
+inline void TStickyNotificationX<TSender, TArguments...>::AddConnection(ConnectionType const& oCnctn, bool bReplay) const
+{
+	m_bReplayOnLink = bReplay;
+	NotificationType::AddConnection(oCnctn);
+	m_bReplayOnLink = true;
+}
+
+template <class TSender, typename... TArguments>
+inline void TStickyNotificationX<TSender, TArguments...>::OnEmit(void* pSender, TArguments... args) const
+{
+	m_oLatest.Store(SLatest {static_cast<TSender*>(pSender), PackType(args...), true});
+}
+
+template <class TSender, typename... TArguments>
+inline void TStickyNotificationX<TSender, TArguments...>::OnLinked(CConnectionBase const& oCnctn) const
+{
+	// Only connections of the signature are linked to the notification
+	if (m_bReplayOnLink)
+		Replay(static_cast<ConnectionType const&>(oCnctn));
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_STICKY_H
@@ -0,0 +1,390 @@
+/*
+	Copyright (C) 2019 by Tigran Khachakranc
+	MIT license:
+	http://en.wikipedia.org/wiki/MIT_License
+*/
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	Waiter (wait for any of several notifications)
+//
+//	Thread sleeps on the futex until any of the attached notifications fires or the timeout expires
+//	Every attached notification gets its wait source, which captures arguments of the emission by value
+//	Emitting side enters the kernel only when the waiting thread sleeps, no mutex/condition variable involved
+//	It is not a latency optimization: wakeup latency and emission cost are on par with the mutex and condition
+//	variable handoff (see bench/bench_waiter.cpp), the point is waiting for several notifications in one place
+//	Source keeps the latest pending emission: emissions made before the waiter takes the value overwrite it
+//	Sources should be attached (and the waiter destroyed) while the notifications are not emitting,
+//	Wait and Take should be called from the one (waiting) thread
+//
+//	Usage example
+//
+/*
+	Waiter				oWaiter;
+	auto&				oData = oWaiter.Attach(oQueue.DataArrived);		// TNotification<int, std::string>
+	auto&				oStop = oWaiter.Attach(oControl.StopRequested);	// TNotification<>
+
+	for (;;)
+	{
+		CWaitSourceBase* pFired = oWaiter.Wait(std::chrono::milliseconds(500));
+		if (pFired == nullptr)
+			...	// timeout
+		else if (pFired == &oStop)
+			break;
+		else if (pFired == &oData)
+		{
+			auto [nId, sText] = oData.Take();
+			...
+		}
+	}
+*/
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef NCD_WAITER_H
+#define NCD_WAITER_H
+
+//
+//	Includes
+//
+#include "ncd_core.h"
+#include "ncd_futex.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace ncd { // Notification - Connection - Delegate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class CWaiter;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CWaitSourceBase
+//	Signature independent part of the wait source: pending state and the link to the waiter
+//
+class CWaitSourceBase
+{
+public:
+	inline virtual ~CWaitSourceBase() = default;
+
+	CWaitSourceBase(CWaitSourceBase const&) = delete;
+	void operator=(CWaitSourceBase const&) = delete;
+
+	// Returns position of the source in the attach order
+	inline size_t GetIndex() const;
+	// Returns true if there is an emission not taken yet
+	inline bool IsPending() const;
+	// Returns number of emissions overwritten before they were taken
+	inline uint32_t GetOverwritten() const;
+
+protected:
+	inline CWaitSourceBase(CWaiter& oWaiter, size_t nIndex);
+
+	//
+	//	Value slot guard: emitting threads and the waiting thread get exclusive access to the value in turn
+	//
+	enum : uint32_t { c_uEmpty = 0, c_uBusy = 1, c_uFull = 2 };
+
+	// Acquires the slot for writing, returns true if pending value is going to be overwritten
+	inline bool BeginWrite();
+	// Publishes written value and wakes the waiter
+	inline void EndWrite();
+	// Acquires the slot for reading, returns false if there is no pending value
+	inline bool BeginRead();
+	inline void EndRead();
+
+protected:
+	CWaiter&				m_oWaiter;
+	size_t const			m_nIndex;
+	std::atomic<uint32_t>	m_uState {c_uEmpty};
+	std::atomic<uint32_t>	m_nOverwritten {0};
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TWaitSource
+//	Connection to the attached notification and the captured arguments of its pending emission
+//
+template <typename... TArguments>
+class TWaitSource final : public CWaitSourceBase
+{
+public:
+	using NotificationType = TNotification<TArguments...>;
+	using ConnectionType = TConnection<TArguments...>;
+	using ValueType = std::tuple<std::decay_t<TArguments>...>;
+
+	inline TWaitSource(CWaiter& oWaiter, size_t nIndex, NotificationType const& oNtfctn);
+
+	// Moves out the pending arguments, returns false if there is no pending emission
+	inline bool Take(ValueType& tValue);
+	// Moves out the pending arguments, should be called only for the source returned by the Wait
+	inline ValueType Take();
+
+private:
+	//
+	//	Implementation
+	//
+	inline void OnEmission(TArguments... args);
+
+private:
+	//
+	//	Contents
+	//
+	ValueType		m_tValue;
+	ConnectionType	m_oCnctn;
+};
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CWaiter
+//	Owns wait sources and blocks the calling thread until any of them becomes pending
+//
+class CWaiter
+{
+public:
+	inline CWaiter() = default;
+	inline ~CWaiter() = default;
+
+	CWaiter(CWaiter const&) = delete;
+	void operator=(CWaiter const&) = delete;
+
+public:
+	//
+	//	Methods
+	//
+
+	// Attaches notification and returns its wait source
+	template <typename... TArguments>
+	inline TWaitSource<TArguments...>& Attach(TNotification<TArguments...> const& oNtfctn);
+	// Disconnects and destroys all wait sources
+	inline void DetachAll();
+	// Returns number of attached sources
+	inline size_t GetSourceCount() const;
+
+	// Blocks until any source becomes pending, returns that source or nullptr if the timeout expired
+	// Pending sources are examined round robin, so frequently firing one could not starve others
+	// Negative timeout means infinite wait
+	inline CWaitSourceBase* Wait(std::chrono::nanoseconds tTimeout = std::chrono::nanoseconds(-1));
+	// Returns pending source without blocking, nullptr if there is no one
+	inline CWaitSourceBase* Poll();
+
+private:
+	//
+	//	Implementation
+	//
+	inline void Signal();
+
+	friend class CWaitSourceBase;
+
+private:
+	//
+	//	Contents
+	//
+	std::vector<std::unique_ptr<CWaitSourceBase>>	m_aSources;
+	size_t											m_nNextScan = 0;
+	std::atomic<uint32_t>							m_uSignal {0};
+	std::atomic<uint32_t>							m_bSleeping {0};
+};
+
+//
+//	Final waiter definition for the external use
+//
+using Waiter = CWaiter;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CWaitSourceBase Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline CWaitSourceBase::CWaitSourceBase(CWaiter& oWaiter, size_t nIndex) :
+	m_oWaiter(oWaiter), m_nIndex(nIndex)
+{
+}
+
+inline size_t CWaitSourceBase::GetIndex() const
+{
+	return m_nIndex;
+}
+
+inline bool CWaitSourceBase::IsPending() const
+{
+	return (m_uState.load(std::memory_order_acquire) == c_uFull);
+}
+
+inline uint32_t CWaitSourceBase::GetOverwritten() const
+{
+	return m_nOverwritten.load(std::memory_order_relaxed);
+}
+
+inline bool CWaitSourceBase::BeginWrite()
+{
+	for (;;)
+	{
+		uint32_t uState = m_uState.load(std::memory_order_relaxed);
+		if (uState != c_uBusy &&
+			m_uState.compare_exchange_weak(uState, c_uBusy, std::memory_order_acquire, std::memory_order_relaxed))
+			return (uState == c_uFull);
+		std::this_thread::yield();
+	}
+}
+
+inline void CWaitSourceBase::EndWrite()
+{
+	m_uState.store(c_uFull, std::memory_order_release);
+	m_oWaiter.Signal();
+}
+
+inline bool CWaitSourceBase::BeginRead()
+{
+	for (;;)
+	{
+		uint32_t uState = c_uFull;
+		if (m_uState.compare_exchange_weak(uState, c_uBusy, std::memory_order_acquire, std::memory_order_relaxed))
+			return true;
+		if (uState == c_uEmpty)
+			return false;
+		if (uState == c_uBusy)
+			std::this_thread::yield();
+	}
+}
+
+inline void CWaitSourceBase::EndRead()
+{
+	m_uState.store(c_uEmpty, std::memory_order_release);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	TWaitSource Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename... TArguments>
+inline TWaitSource<TArguments...>::TWaitSource(CWaiter& oWaiter, size_t nIndex, NotificationType const& oNtfctn) :
+	CWaitSourceBase(oWaiter, nIndex), m_tValue()
+{
+	using Me = TWaitSource<TArguments...>;
+	using DelegateType = typename ConnectionType::DelegateType;
+
+	m_oCnctn.Init(oNtfctn, DelegateType::template Create<Me, &Me::OnEmission>(*this));
+}
+
+template <typename... TArguments>
+inline bool TWaitSource<TArguments...>::Take(ValueType& tValue)
+{
+	if (!BeginRead())
+		return false;
+	tValue = std::move(m_tValue);
+	EndRead();
+	return true;
+}
+
+template <typename... TArguments>
+inline typename TWaitSource<TArguments...>::ValueType TWaitSource<TArguments...>::Take()
+{
+	ValueType tValue;
+	Take(tValue);
+	return tValue;
+}
+
+template <typename... TArguments>
+inline void TWaitSource<TArguments...>::OnEmission(TArguments... args)
+{
+	// Counter is changed only by the slot owner, so it needs no read-modify-write
+	if (BeginWrite())
+		m_nOverwritten.store(m_nOverwritten.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	m_tValue = ValueType(args...);
+	EndWrite();
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	CWaiter Implementation
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename... TArguments>
+inline TWaitSource<TArguments...>& CWaiter::Attach(TNotification<TArguments...> const& oNtfctn)
+{
+	auto pSource = new TWaitSource<TArguments...>(*this, m_aSources.size(), oNtfctn);
+	m_aSources.emplace_back(pSource);
+	return *pSource;
+}
+
+inline void CWaiter::DetachAll()
+{
+	m_aSources.clear();
+	m_nNextScan = 0;
+}
+
+inline size_t CWaiter::GetSourceCount() const
+{
+	return m_aSources.size();
+}
+
+inline CWaitSourceBase* CWaiter::Poll()
+{
+	size_t const nCount = m_aSources.size();
+	for (size_t i = 0; i < nCount; ++i)
+	{
+		size_t nIdx = (m_nNextScan + i) % nCount;
+		if (m_aSources[nIdx]->IsPending())
+		{
+			m_nNextScan = (nIdx + 1) % nCount;
+			return m_aSources[nIdx].get();
+		}
+	}
+	return nullptr;
+}
+
+inline CWaitSourceBase* CWaiter::Wait(std::chrono::nanoseconds tTimeout)
+{
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point const tDeadline = (tTimeout.count() >= 0) ? Clock::now() + tTimeout : Clock::time_point::max();
+
+	for (;;)
+	{
+		// Signal is read before the scan, emission made after the scan changes it and fails the futex wait
+		uint32_t uSeen = m_uSignal.load(std::memory_order_seq_cst);
+		if (CWaitSourceBase* pSource = Poll())
+			return pSource;
+
+		std::chrono::nanoseconds tLeft(-1);
+		if (tTimeout.count() >= 0)
+		{
+			tLeft = std::chrono::duration_cast<std::chrono::nanoseconds>(tDeadline - Clock::now());
+			if (tLeft.count() <= 0)
+				return nullptr;
+		}
+
+		m_bSleeping.store(1, std::memory_order_seq_cst);
+		futex::Wait(m_uSignal, uSeen, tLeft);
+		m_bSleeping.store(0, std::memory_order_relaxed);
+	}
+}
+
+inline void CWaiter::Signal()
+{
+	m_uSignal.fetch_add(1, std::memory_order_seq_cst);
+	if (m_bSleeping.load(std::memory_order_seq_cst) != 0)
+		futex::WakeOne(m_uSignal);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+} // namespace ncd
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //NCD_WAITER_H
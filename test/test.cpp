@@ -2,8 +2,36 @@
 //	Includes
 //
 #include "../src/ncd_core.h"
-
+#include "../src/ncd_classwide.h"
+#include "../src/ncd_combine.h"
+#include "../src/ncd_futex.h"
+#include "../src/ncd_graph.h"
+#include "../src/ncd_handle.h"
+#include "../src/ncd_latency.h"
+#include "../src/ncd_payload.h"
+#include "../src/ncd_property.h"
+#include "../src/ncd_record.h"
+#include "../src/ncd_ring.h"
+#include "../src/ncd_sharded.h"
+#include "../src/ncd_sticky.h"
+#include "../src/ncd_waiter.h"
+#if defined(__linux__)
+#include "../src/ncd_shm.h"
+#endif
+#if defined(__cpp_impl_coroutine)
+#include "../src/ncd_coro.h"
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 using namespace ncd;
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -156,6 +184,204 @@ public:
 	}
 };
 
+// Receiver which could be kept in containers, its owner aware connection follows it when relocated
+class CMovableListener
+{
+public:
+	explicit CMovableListener(int nId) :
+		m_nId(nId)
+	{
+		m_onSomethingChanged.Init<&CMovableListener::onSomethingChanged>(*this);
+	}
+
+	CMovableListener(CMovableListener&&) = default;
+	CMovableListener& operator=(CMovableListener&&) = default;
+
+	void onSomethingChanged(int, int b)
+	{
+		m_nSum += b + m_nId;
+	}
+
+	int m_nId;
+	int m_nSum = 0;
+	Connection<decltype(&CMovableListener::onSomethingChanged)> m_onSomethingChanged;
+};
+
+// Receiver which keeps its handle connection, the connection is constructed with its owner and follows it
+class CHandleListener
+{
+public:
+	explicit CHandleListener(int nId) :
+		m_nId(nId)
+	{
+	}
+
+	CHandleListener(CHandleListener&&) = default;
+
+	void onSomethingChanged(int, int b)
+	{
+		m_nSum += b + m_nId;
+	}
+
+	int m_nId;
+	int m_nSum = 0;
+	HandleConnection<int, int> m_onSomethingChanged
+		{*this, HandleConnection<int, int>::DelegateType::Create<CHandleListener, &CHandleListener::onSomethingChanged>(*this)};
+};
+
+// Static listener declared with the static connection macros
+class CStaticListener
+{
+public:
+	static void onSomethingChanged(int, int);
+	NCD_DECLARE_CONNECTION_STATIC(onSomethingChanged)
+
+	static void Listen(TNotification<int, int> const& oNtfctn)
+	{
+		NCD_INIT_CONNECTION_STATIC_AND_LINK(CStaticListener, onSomethingChanged, oNtfctn)
+	}
+
+	static int s_nCalls;
+};
+
+NCD_DEFINE_CONNECTION_STATIC(CStaticListener, onSomethingChanged)
+int CStaticListener::s_nCalls = 0;
+
+void CStaticListener::onSomethingChanged(int, int)
+{
+	++s_nCalls;
+}
+
+// Static listener whose connection is first used concurrently
+class CRacingStaticListener
+{
+public:
+	static void onSomethingChanged(int, int) {}
+	NCD_DECLARE_CONNECTION_STATIC(onSomethingChanged)
+};
+
+NCD_DEFINE_CONNECTION_STATIC(CRacingStaticListener, onSomethingChanged)
+
+// Listener which is slow for the value 1, it is timed on every second invocation
+class CSlowListener
+{
+public:
+	CSlowListener()
+	{
+		m_onValue.Init<CSlowListener, &CSlowListener::onValue>(*this, 2);
+	}
+
+	void onValue(int nValue, int)
+	{
+		if (nValue == 1)
+			std::this_thread::sleep_for(std::chrono::microseconds(300));
+		++m_nCalls;
+	}
+
+	TProfiledConnection<int, int> m_onValue;
+	int m_nCalls = 0;
+};
+
+// Property value without the default constructor
+struct SExtent
+{
+	explicit SExtent(int nValue) : m_nValue(nValue) {}
+	bool operator==(SExtent const& other) const {return m_nValue == other.m_nValue;}
+
+	int m_nValue;
+};
+
+// Sender with properties
+class CWindow
+{
+public:
+	Property<int, CWindow>		Width {*this, 640};
+	Property<SExtent, CWindow>	Extent {*this, SExtent(1)};
+};
+
+// Sender observed through the class-wide notification
+class CSession
+{
+public:
+	static ClassNotification<CSession, int> Closed;
+
+	explicit CSession(int nId) : m_nId(nId) {}
+
+	void Close()
+	{
+		Closed.Notify(this, m_nId);
+		Closed.ForgetSender(this);
+	}
+
+	int m_nId;
+};
+
+ClassNotification<CSession, int> CSession::Closed;
+
+// Appends its id to the shared invocation log
+class Recorder
+{
+public:
+	inline void operator()(int, int)
+	{
+		m_pLog->push_back(m_nId);
+	}
+
+	std::vector<int>* m_pLog = nullptr;
+	int m_nId = 0;
+};
+
+// Counts its invocations
+class Counter
+{
+public:
+	inline void operator()(int, int)
+	{
+		++m_nCalls;
+	}
+
+	int m_nCalls = 0;
+};
+
+// Counts the cascades it was scheduled within, scheduling listener remembers whether it was queued
+class CCascadeCounter : public CCascadeHook
+{
+public:
+	inline void operator()(int, int)
+	{
+		m_bQueued = Schedule();
+	}
+
+	int m_nCascades = 0;
+	bool m_bQueued = false;
+
+protected:
+	inline void OnCascadeEnd() override
+	{
+		++m_nCascades;
+	}
+};
+
+// Behaviour checks, failed ones are reported and fail the test run
+static int g_nFailedChecks = 0;
+
+#define NCD_CHECK(_Condition_)																						\
+	if (!(_Condition_))																								\
+	{																												\
+		std::cout << "Check failed (line " << __LINE__ << "): " #_Condition_ << std::endl;							\
+		++g_nFailedChecks;																							\
+	}
+
+#if defined(__cpp_impl_coroutine)
+// Awaits the next emission and destroys the sender which resumed it
+CTask AwaitAndDestroy(std::unique_ptr<CSender1>& pSender, std::vector<int>& aEvents)
+{
+	auto [a, b] = co_await pSender->SomethingChanged;
+	aEvents.push_back(a + b);
+	pSender.reset();
+}
+#endif
+
 
 class CListener3
 {
@@ -378,6 +604,1014 @@ int main()
 	pSender2->DoSomething();
 	pSender2->DoNothing();
 
+	// Bulk teardown of many connections listening the same notification
+	{
+		Counter oCounter;
+		TConnection<int, int> aCnctns[16];
+		ConnectionGroup oGroup;
+		for (auto& oCnctn : aCnctns)
+		{
+			oCnctn.Init(pSender2->SomethingChanged, TConnection<int, int>::DelegateType::Create<Counter>(oCounter));
+			oGroup += oCnctn;
+			oGroup += oCnctn;
+		}
+		NCD_CHECK(oGroup.GetSize() == 16);
+
+		pSender2->DoSomething();
+		NCD_CHECK(oCounter.m_nCalls == 16);
+		oGroup.DisconnectAll();
+		NCD_CHECK(oGroup.IsEmpty());
+		pSender2->DoSomething();
+		NCD_CHECK(oCounter.m_nCalls == 16);
+		NCD_CHECK(!aCnctns[0].HasConnectedNotifications());
+	}
+
+	// Destroyed connections release their slots without searching, the invocation order of the rest is kept
+	{
+		std::vector<int> aLog;
+		Recorder aRecorders[8];
+		std::vector<std::unique_ptr<TConnection<int, int>>> aCnctns;
+		for (int i = 0; i < 8; ++i)
+		{
+			aRecorders[i].m_pLog = &aLog;
+			aRecorders[i].m_nId = i;
+			aCnctns.emplace_back(new TConnection<int, int>(pSender2->SomethingChanged, TConnection<int, int>::DelegateType::Create<Recorder>(aRecorders[i])));
+		}
+		for (int i : {0, 2, 4, 7})
+			aCnctns[i].reset();
+		pSender2->DoSomething();
+		NCD_CHECK((aLog == std::vector<int> {1, 3, 5, 6}));
+
+		// Added again moves to the end, connecting again keeps the order
+		aLog.clear();
+		pSender2->SomethingChanged.AddConnection(*aCnctns[1]);
+		aCnctns[3]->Connect(pSender2->SomethingChanged);
+		pSender2->DoSomething();
+		NCD_CHECK((aLog == std::vector<int> {3, 5, 6, 1}));
+
+		aLog.clear();
+		aCnctns[5]->Disconnect(pSender2->SomethingChanged);
+		NCD_CHECK(!pSender2->SomethingChanged.IsConnected(*aCnctns[5]) && pSender2->SomethingChanged.IsConnected(*aCnctns[6]));
+		aCnctns[3].reset();
+		pSender2->DoSomething();
+		NCD_CHECK((aLog == std::vector<int> {6, 1}));
+	}
+
+	// One-shot connection disconnects itself after the first invocation
+	{
+		Counter oCounter;
+		TConnection<int, int> oOnceCnctn(TConnection<int, int>::DelegateType::Create<Counter>(oCounter));
+		NCD_CHECK(oOnceCnctn.ConnectOnce(pSender2->SomethingChanged));
+
+		pSender2->DoSomething();
+		pSender2->DoSomething();
+		NCD_CHECK(oCounter.m_nCalls == 1);
+		NCD_CHECK(!oOnceCnctn.HasConnectedNotifications());
+	}
+
+	// Shots are counted per connection, so connection linked to several notifications could not be limited
+	{
+		CSender1 oSender;
+		Counter oCounter;
+		TConnection<int, int> oCnctn(TConnection<int, int>::DelegateType::Create<Counter>(oCounter));
+		oCnctn.Connect(oSender.SomethingChanged);
+		NCD_CHECK(!oCnctn.ConnectOnce(pSender2->SomethingChanged));
+		NCD_CHECK(!oCnctn.IsConnected(pSender2->SomethingChanged));
+		NCD_CHECK(oCnctn.GetShotsLeft() == 0);
+
+		oCnctn.Connect(pSender2->SomethingChanged);
+		NCD_CHECK(!oCnctn.SetShotLimit(1));
+
+		// Unrelated links survive the emissions of both notifications
+		pSender2->DoSomething();
+		oSender.DoSomething();
+		NCD_CHECK(oCounter.m_nCalls == 2);
+		NCD_CHECK(oCnctn.IsConnected(oSender.SomethingChanged) && oCnctn.IsConnected(pSender2->SomethingChanged));
+
+		// Limited connection of the same notification could be limited again
+		oCnctn.DisconnectAll();
+		NCD_CHECK(oCnctn.ConnectShots(oSender.SomethingChanged, 2));
+		NCD_CHECK(oCnctn.ConnectShots(oSender.SomethingChanged, 3));
+		for (int i = 0; i < 4; ++i)
+			oSender.DoSomething();
+		NCD_CHECK(oCounter.m_nCalls == 5);
+		NCD_CHECK(!oSender.SomethingChanged.HasConnections());
+	}
+
+	// Chained notification is reachable through its cnt_Notify connection, which knows the notification it emits
+	{
+		CSender1 oSenderA, oSenderB;
+		Counter oCounter;
+		TConnection<int, int> oCnctn(oSenderA.SomethingChanged, TConnection<int, int>::DelegateType::Create<Counter>(oCounter));
+		oSenderA.SomethingChanged.cnt_Notify.Connect(oSenderB.SomethingChanged);
+		NCD_CHECK(oSenderA.SomethingChanged.cnt_Notify.Get().GetForwardTarget() == &oSenderA.SomethingChanged);
+		NCD_CHECK(oCnctn.GetForwardTarget() == nullptr);
+
+		CGraphSnapshot oSnapshot;
+		oSnapshot.AddRoot(oSenderB.SomethingChanged);
+		oSnapshot.Capture();
+		NCD_CHECK(oSnapshot.GetNodes().size() == 4);
+		NCD_CHECK(oSnapshot.GetEdges().size() == 3);
+		NCD_CHECK(oSnapshot.GetMaxChainDepth() == 1);
+
+		// Relocated notification becomes the forward target
+		Notification<CSender1, int, int> oMoved(std::move(oSenderA.SomethingChanged));
+		NCD_CHECK(oMoved.cnt_Notify.Get().GetForwardTarget() == &oMoved);
+		oSenderB.DoSomething();
+		NCD_CHECK(oCounter.m_nCalls == 1);
+	}
+
+	// Cycle members are marked, long chains are walked without recursion
+	{
+		CSender1 oSenderA, oSenderB;
+		oSenderA.SomethingChanged.cnt_Notify.Connect(oSenderB.SomethingChanged);
+		oSenderB.SomethingChanged.cnt_Notify.Connect(oSenderA.SomethingChanged);
+
+		CGraphSnapshot oSnapshot;
+		oSnapshot.AddRoot(oSenderA.SomethingChanged);
+		oSnapshot.Capture();
+		NCD_CHECK(oSnapshot.GetNodes().size() == 4 && oSnapshot.GetCycleNodeCount() == 4);
+		NCD_CHECK(oSnapshot.ToJson().find("\"inCycle\":true") != std::string::npos);
+		oSenderA.SomethingChanged.cnt_Notify.DisconnectAll();
+
+		std::vector<Notification<CSender1, int>> aChain(100000);
+		for (size_t i = 1; i < aChain.size(); ++i)
+			aChain[i].cnt_Notify.Connect(aChain[i - 1]);
+		oSnapshot.Clear();
+		oSnapshot.AddRoot(aChain.front());
+		oSnapshot.Capture();
+		NCD_CHECK(oSnapshot.GetNodes().size() == 2 * aChain.size() - 1);
+		NCD_CHECK(oSnapshot.GetMaxChainDepth() == aChain.size() - 1 && oSnapshot.GetCycleNodeCount() == 0);
+	}
+
+	// Receivers are relocated by the container, their connections rebind the delegates
+	// Plain TConnection is not movable, it could not tell whether its delegate target moved along with it
+	{
+		static_assert(!std::is_move_constructible<TConnection<int, int>>::value, "Plain connection should not be relocatable");
+		static_assert(std::is_move_constructible<CMovableListener>::value, "Owner aware connection should be relocatable");
+
+		CSender1 oSender;
+		std::vector<CMovableListener> aListeners;
+		for (int i = 0; i < 16; ++i)
+		{
+			aListeners.emplace_back(i);
+			aListeners.back().m_onSomethingChanged.Connect(oSender.SomethingChanged);
+		}
+		oSender.DoSomething();
+		for (CMovableListener const& oListener : aListeners)
+			NCD_CHECK(oListener.m_nSum == oListener.m_nId + 1);
+
+		// Move assignment shifts the rest of the listeners
+		aListeners.erase(aListeners.begin());
+		oSender.DoSomething();
+		for (CMovableListener const& oListener : aListeners)
+		{
+			NCD_CHECK(oListener.m_nSum == 2 * (oListener.m_nId + 1));
+			NCD_CHECK(oListener.m_onSomethingChanged.IsConnected(oSender.SomethingChanged));
+		}
+
+		// Connection kept outside of its receiver keeps the receiver when relocated
+		CMovableListener oOuter(100);
+		std::vector<Connection<decltype(&CMovableListener::onSomethingChanged)>> aCnctns(1);
+		aCnctns[0].Init<&CMovableListener::onSomethingChanged>(oSender.SomethingChanged, oOuter);
+		aCnctns.emplace_back();
+		aCnctns.erase(aCnctns.begin() + 1);
+		oSender.DoSomething();
+		NCD_CHECK(oOuter.m_nSum == 101 && oOuter.m_onSomethingChanged.GetDelegate().GetTarget() == &oOuter);
+		NCD_CHECK(aCnctns[0].GetDelegate().GetTarget() == &oOuter);
+	}
+
+	// Deduplicated connection is invoked once per top-level emission, even if it is reached by several chained paths
+	{
+		CSender1 oSender;
+		Notification<CSender1, int, int> oLeft, oRight;
+		oLeft.cnt_Notify.Connect(oSender.SomethingChanged);
+		oRight.cnt_Notify.Connect(oSender.SomethingChanged);
+
+		Counter oCounter;
+		TConnection<int, int> oCnctn(TConnection<int, int>::DelegateType::Create<Counter>(oCounter));
+		oCnctn.Connect(oLeft);
+		oCnctn.Connect(oRight);
+		oCnctn.SetDeduplicated(true);
+		oSender.DoSomething();
+		oSender.DoSomething();
+		NCD_CHECK(oCounter.m_nCalls == 2);
+
+		// Emissions made by different threads have distinct epochs, so none of them is skipped
+		for (int i = 0; i < 4; ++i)
+			std::thread([&oSender]() { oSender.DoSomething(); }).join();
+		NCD_CHECK(oCounter.m_nCalls == 6);
+	}
+
+	// Plain emission does not open the cascade, tracked connection linked to the notification makes it do so
+	{
+		CSender1 oSender;
+		CCascadeCounter oHook;
+		TConnection<int, int> oCnctn(oSender.SomethingChanged, TConnection<int, int>::DelegateType::Create<CCascadeCounter>(oHook));
+		oSender.DoSomething();
+		NCD_CHECK(!oHook.m_bQueued && oHook.m_nCascades == 0);
+
+		oCnctn.SetCascadeListener(true);
+		oSender.DoSomething();
+		NCD_CHECK(oHook.m_bQueued && oHook.m_nCascades == 1);
+
+		// Tracked count follows the flags of the linked connections and their removal
+		oCnctn.SetCascadeListener(false);
+		Counter oCounter;
+		TConnection<int, int> oLimited(oSender.SomethingChanged, TConnection<int, int>::DelegateType::Create<Counter>(oCounter));
+		oLimited.SetShotLimit(1);
+		oSender.DoSomething();
+		NCD_CHECK(oHook.m_bQueued && oHook.m_nCascades == 2 && oCounter.m_nCalls == 1);
+		oSender.DoSomething();
+		NCD_CHECK(!oHook.m_bQueued && oHook.m_nCascades == 2 && oCounter.m_nCalls == 1);
+		oLimited.SetDeduplicated(true);
+		oLimited.Connect(oSender.SomethingChanged);
+		oSender.DoSomething();
+		NCD_CHECK(oHook.m_bQueued && oHook.m_nCascades == 3 && oCounter.m_nCalls == 2);
+		oLimited.DisconnectAll();
+		oSender.DoSomething();
+		NCD_CHECK(!oHook.m_bQueued && oHook.m_nCascades == 3);
+	}
+
+	// Combinators coalesce the inputs fired within one cascade, zip waits for every input, reset forgets them
+	{
+		using CombinedConnection = TConnection<std::tuple<int, int> const&, std::tuple<> const&>;
+		CSender1 oSender;
+		int nLatest = 0;
+		int nZipped = 0;
+		auto fnLatest = [&nLatest](std::tuple<int, int> const&, std::tuple<> const&) { ++nLatest; };
+		auto fnZipped = [&nZipped](std::tuple<int, int> const&, std::tuple<> const&) { ++nZipped; };
+
+		CombineLatest<TNotification<int, int>, TNotification<>> oLatest(oSender.SomethingChanged, oSender.NothingChanged);
+		Zip<TNotification<int, int>, TNotification<>> oZip(oSender.SomethingChanged, oSender.NothingChanged);
+		CombinedConnection oLatestCnctn(oLatest.GetNotification(), CombinedConnection::DelegateType::Create(fnLatest));
+		CombinedConnection oZipCnctn(oZip.GetNotification(), CombinedConnection::DelegateType::Create(fnZipped));
+
+		oSender.DoSomething();
+		oSender.DoNothing();
+		NCD_CHECK(nLatest == 1 && nZipped == 1);
+
+		// Both inputs fired within one cascade give a single result
+		auto fnCascade = [&oSender](int, int) { oSender.DoNothing(); };
+		TConnection<int, int> oCascadeCnctn(TConnection<int, int>::DelegateType::Create(fnCascade));
+		oCascadeCnctn.Connect(oSender.SomethingChanged);
+		oSender.DoSomething();
+		NCD_CHECK(nLatest == 2 && nZipped == 2);
+		oCascadeCnctn.DisconnectAll();
+
+		oSender.DoSomething();
+		oZip.Reset();
+		oSender.DoNothing();
+		NCD_CHECK(nZipped == 2);
+		oSender.DoSomething();
+		NCD_CHECK(nZipped == 3);
+	}
+
+#if defined(__cpp_impl_coroutine)
+	// Coroutine awaiting the emission is resumed after the emission ends, so it could destroy the sender
+	{
+		std::vector<int> aEvents;
+		auto fnLater = [&aEvents](int, int) {aEvents.push_back(100);};
+		auto pSender = std::make_unique<CSender1>();
+		AwaitAndDestroy(pSender, aEvents);
+		TConnection<int, int> oLater(pSender->SomethingChanged, TConnection<int, int>::DelegateType::Create(fnLater));
+		pSender->DoSomething();
+		NCD_CHECK(pSender == nullptr);
+		NCD_CHECK(aEvents == std::vector<int>({100, 1}));
+		NCD_CHECK(!oLater.HasConnectedNotifications());
+
+		// Emissions nested into the awaited one resume the coroutine when the top-level one ends
+		CSender1 oOuter;
+		pSender = std::make_unique<CSender1>();
+		oOuter.SomethingChanged.AddConnection(pSender->SomethingChanged.cnt_Notify);
+		aEvents.clear();
+		AwaitAndDestroy(pSender, aEvents);
+		oOuter.DoSomething();
+		NCD_CHECK(pSender == nullptr);
+		NCD_CHECK(aEvents == std::vector<int>({1}));
+		NCD_CHECK(!oOuter.SomethingChanged.HasConnections());
+	}
+
+#endif
+	// Sharded notification invokes the subscriptions of every shard, released subscription is not invoked anymore
+	{
+		ShardedNotification<CSender1, int, int> oSharded(4);
+		using ShardedDelegate = ShardedNotification<CSender1, int, int>::DelegateType;
+		std::atomic<int> nCalls {0};
+		auto fnCount = [&nCalls](int, int) {++nCalls;};
+		ShardedNotification<CSender1, int, int>::CSubscription oLocal = oSharded.Subscribe(ShardedDelegate::Create(fnCount));
+		ShardedNotification<CSender1, int, int>::CSubscription oRemote;
+		std::thread([&]() { oRemote = oSharded.Subscribe(ShardedDelegate::Create(fnCount)); }).join();
+		NCD_CHECK(oSharded.GetCount() == 2);
+
+		oSharded.Notify(nullptr, 1, 1);
+		std::thread([&oSharded]() { oSharded.Notify(nullptr, 1, 1); }).join();
+		NCD_CHECK(nCalls == 4);
+
+		oRemote.Release();
+		oSharded.Notify(nullptr, 1, 1);
+		NCD_CHECK(nCalls == 5 && oSharded.GetCount() == 1);
+	}
+
+	// Sharded subscription released by its own handler defers the grace period until the emission ends
+	{
+		ShardedNotification<CSender1, int, int> oSharded(4);
+		using ShardedDelegate = ShardedNotification<CSender1, int, int>::DelegateType;
+		ShardedNotification<CSender1, int, int>::CSubscription oSubscription;
+		std::thread::id const idMain = std::this_thread::get_id();
+		int nCalls = 0;
+		auto fnRelease = [&](int, int)
+		{
+			if (std::this_thread::get_id() != idMain)
+				return;
+			++nCalls;
+			oSubscription.Release();
+		};
+		oSubscription = oSharded.Subscribe(ShardedDelegate::Create(fnRelease));
+
+		// Another thread keeps emitting meanwhile, its emissions are waited after the handler returns
+		std::atomic<bool> bStop {false};
+		std::thread oEmitter([&]() {
+			while (!bStop.load())
+				oSharded.Notify(nullptr, 0, 0);
+		});
+		while (nCalls == 0)
+			oSharded.Notify(nullptr, 1, 1);
+		bStop.store(true);
+		oEmitter.join();
+
+		NCD_CHECK(oSharded.GetCount() == 0);
+		int const nReleasedAt = nCalls;
+		oSharded.Notify(nullptr, 1, 1);
+		NCD_CHECK(nCalls == nReleasedAt);
+	}
+
+#if defined(__linux__)
+	// Shared memory receiver pumps all available emissions when the batch is not limited
+	{
+		CSender1 oSource, oTarget;
+		TShmPublisher<int, int> cntPublisher;
+		TShmReceiver<CSender1, int, int> oReceiver(oTarget.SomethingChanged, &oTarget);
+		NCD_CHECK(cntPublisher.Create("/ncd_test_pump", 8));
+		NCD_CHECK(oReceiver.Open("/ncd_test_pump"));
+		cntPublisher.Connect(oSource.SomethingChanged);
+		Counter oCounter;
+		TConnection<int, int> oCnctn(oTarget.SomethingChanged, TConnection<int, int>::DelegateType::Create(oCounter));
+
+		for (int i = 0; i < 3; ++i)
+			oSource.DoSomething();
+		NCD_CHECK(oReceiver.Pump(2, std::chrono::milliseconds(0)) == EShmStatus::Ok && oCounter.m_nCalls == 2);
+		NCD_CHECK(oReceiver.Pump(0, std::chrono::milliseconds(0)) == EShmStatus::Ok && oCounter.m_nCalls == 3);
+		for (int i = 0; i < 5; ++i)
+			oSource.DoSomething();
+		NCD_CHECK(oReceiver.Pump(0, std::chrono::milliseconds(0)) == EShmStatus::Ok && oCounter.m_nCalls == 8);
+		NCD_CHECK(oReceiver.Pump(0, std::chrono::milliseconds(0)) == EShmStatus::Timeout);
+
+		// Full ring drops the emissions by default instead of stalling the emitting thread
+		for (int i = 0; i < 10; ++i)
+			oSource.DoSomething();
+		NCD_CHECK(cntPublisher.GetDroppedCount() == 2);
+
+		// Emissions delivered to the throwing listener are consumed, the next pump goes on after them
+		bool bThrow = true;
+		auto fnThrow = [&bThrow](int, int)
+		{
+			if (bThrow)
+				throw std::runtime_error("listener failed");
+		};
+		TConnection<int, int> oThrowing(oTarget.SomethingChanged, TConnection<int, int>::DelegateType::Create(fnThrow));
+		bool bThrown = false;
+		try
+		{
+			oReceiver.Pump(0, std::chrono::milliseconds(0));
+		}
+		catch (std::runtime_error const&)
+		{
+			bThrown = true;
+		}
+		NCD_CHECK(bThrown && oCounter.m_nCalls == 9);
+		bThrow = false;
+		NCD_CHECK(oReceiver.Pump(0, std::chrono::milliseconds(0)) == EShmStatus::Ok && oCounter.m_nCalls == 16);
+		oReceiver.Close();
+		cntPublisher.Close();
+	}
+
+#endif
+	// Multicast ring delivers every emission to every consumer thread in the publishing order
+	{
+		RingNotification<CSender1, int, int> oRing(64);
+		std::vector<int> aFirst;
+		int64_t nSecondSum = 0;
+		auto fnFirst = [&aFirst](int a, int) {aFirst.push_back(a);};
+		auto fnSecond = [&nSecondSum](int a, int b) {nSecondSum += a + b;};
+		TConnection<int, int> oFirst(TConnection<int, int>::DelegateType::Create(fnFirst));
+		TConnection<int, int> oSecond(TConnection<int, int>::DelegateType::Create(fnSecond));
+		NCD_CHECK(oRing.AddConsumer(oFirst));
+		NCD_CHECK(oRing.AddConsumer(oSecond));
+		NCD_CHECK(!oRing.AddConsumer(oSecond));
+
+		// Ring is fed through its chaining connection, publishing waits while the ring is full
+		CSender1 oSender;
+		oRing.cnt_Notify.Connect(oSender.SomethingChanged);
+		oRing.Start();
+		int const nCount = 10000;
+		for (int i = 0; i < nCount; ++i)
+			oSender.SomethingChanged.Notify(&oSender, i, 1);
+		oRing.Stop();
+
+		bool bOrdered = (aFirst.size() == nCount);
+		for (size_t i = 0; bOrdered && i < aFirst.size(); ++i)
+			bOrdered = (aFirst[i] == static_cast<int>(i));
+		NCD_CHECK(bOrdered);
+		NCD_CHECK(nSecondSum == int64_t(nCount) * (nCount - 1) / 2 + nCount);
+	}
+
+	// Sticky notification keeps the latest emission, replays it to new connections and reads it without tearing
+	{
+		StickyNotification<CSender1, int, int> oSticky;
+		std::tuple<int, int> tLatest;
+		NCD_CHECK(!oSticky.HasLatest() && !oSticky.GetLatest(tLatest));
+
+		CSender1 oSender;
+		oSticky.Notify(&oSender, 5, 6);
+		CSender1* pSender = nullptr;
+		NCD_CHECK(oSticky.GetLatest(tLatest, &pSender) && tLatest == std::make_tuple(5, 6) && pSender == &oSender);
+
+		Counter oReplayed, oSilent;
+		TConnection<int, int> oReplayedCnctn(TConnection<int, int>::DelegateType::Create(oReplayed));
+		TConnection<int, int> oSilentCnctn(TConnection<int, int>::DelegateType::Create(oSilent));
+		oSticky.AddConnection(oReplayedCnctn, true);
+		oSticky.AddConnection(oSilentCnctn, false);
+		NCD_CHECK(oReplayed.m_nCalls == 1 && oSilent.m_nCalls == 0);
+
+		// Plain connect replays too, emissions through the base notification or the chain are cached
+		Counter oConnected;
+		TConnection<int, int> oConnectedCnctn(TConnection<int, int>::DelegateType::Create(oConnected));
+		oConnectedCnctn.Connect(oSticky);
+		NCD_CHECK(oConnected.m_nCalls == 1);
+		TNotification<int, int> const& oBase = oSticky;
+		oBase.Notify(&oSender, 7, 8);
+		NCD_CHECK(oSticky.GetLatest(tLatest) && tLatest == std::make_tuple(7, 8) && oConnected.m_nCalls == 2);
+		CSender1 oUpstream;
+		oUpstream.SomethingChanged.AddConnection(oSticky.cnt_Notify);
+		oUpstream.DoSomething();
+		NCD_CHECK(oSticky.GetLatest(tLatest) && tLatest == std::make_tuple(0, 1) && oConnected.m_nCalls == 3);
+		{
+			auto oBlock = oSticky.Block();
+			NCD_CHECK(oSticky.NotifyLazy(&oSender, []() {return std::make_tuple(9, 10);}));
+		}
+		NCD_CHECK(oSticky.GetLatest(tLatest) && tLatest == std::make_tuple(9, 10) && oConnected.m_nCalls == 3);
+		oUpstream.SomethingChanged.RemoveAllConnections();
+
+		oSticky.ResetLatest();
+		NCD_CHECK(!oSticky.HasLatest());
+
+		// Reader never sees the arguments of two different emissions mixed
+		std::atomic<bool> bStop {false};
+		bool bTorn = false;
+		std::thread oReader([&]() {
+			std::tuple<int, int> tValue;
+			while (!bStop.load())
+			{
+				if (oSticky.GetLatest(tValue) && std::get<0>(tValue) != -std::get<1>(tValue))
+					bTorn = true;
+			}
+		});
+		oSticky.RemoveAllConnections();
+		for (int i = 0; i < 200000; ++i)
+			oSticky.Notify(&oSender, i, -i);
+		bStop.store(true);
+		oReader.join();
+		NCD_CHECK(!bTorn);
+	}
+
+	// Recorded emissions are replayed into the registered notifications with the recorded arguments
+	{
+		char const* const szLog = "ncd_test_record.ncdr";
+		CSender1 oSource;
+		{
+			CEmissionRecorder oRecorder;
+			NCD_CHECK(oRecorder.Open(szLog, 1 << 20));
+			TRecorderConnection<int, int> cntRecSomething(oRecorder, 1);
+			TRecorderConnection<> cntRecNothing(oRecorder, 2);
+			cntRecSomething.Connect(oSource.SomethingChanged);
+			cntRecNothing.Connect(oSource.NothingChanged);
+			// Another thread records into its own chunk
+			std::thread oWorker([&oRecorder]() {
+				for (int i = 0; i < 100; ++i)
+					oRecorder.Record<>(2);
+			});
+			for (int i = 0; i < 100; ++i)
+			{
+				oSource.SomethingChanged.Notify(&oSource, i, 1);
+				oSource.DoNothing();
+			}
+			oWorker.join();
+			NCD_CHECK(oRecorder.GetDroppedCount() == 0);
+			oRecorder.Close();
+		}
+
+		CSender1 oTarget;
+		int nSum = 0;
+		auto fnSum = [&nSum](int a, int b) {nSum += a + b;};
+		int nNothing = 0;
+		auto fnNothing = [&nNothing]() {++nNothing;};
+		TConnection<int, int> oSumCnctn(oTarget.SomethingChanged, TConnection<int, int>::DelegateType::Create(fnSum));
+		TConnection<> oNothingCnctn(oTarget.NothingChanged, TConnection<>::DelegateType::Create(fnNothing));
+		CEmissionReplayer oReplayer;
+		NCD_CHECK(oReplayer.Open(szLog));
+		oReplayer.Register(1, oTarget.SomethingChanged, &oTarget);
+		oReplayer.Register(2, oTarget.NothingChanged, &oTarget);
+		NCD_CHECK(oReplayer.Replay() == 300);
+		NCD_CHECK(nSum == 99 * 100 / 2 + 100 && nNothing == 200);
+		oReplayer.Close();
+		std::remove(szLog);
+
+		// Records which do not fit the capacity are dropped and counted
+		CEmissionRecorder oSmall;
+		NCD_CHECK(oSmall.Open(szLog, 64));
+		for (int i = 0; i < 10; ++i)
+			oSmall.Record<int>(1, i);
+		NCD_CHECK(oSmall.GetDroppedCount() == 8 && oSmall.GetRecordedSize() == 64);
+		oSmall.Close();
+		std::remove(szLog);
+	}
+
+	// Profiled connection samples its listener latency, watchdog reports listeners over the budget once
+	{
+		CLatencyHistogram oHistogram;
+		for (uint64_t i = 0; i < 1000; ++i)
+			oHistogram.Record(i);
+		NCD_CHECK(oHistogram.GetCount() == 1000);
+		NCD_CHECK(oHistogram.GetPercentile(50) >= 500 && oHistogram.GetPercentile(50) <= 575);
+		NCD_CHECK(oHistogram.GetPercentile(99) >= 990 && oHistogram.GetPercentile(99) <= 1100);
+
+		CSender1 oSender;
+		CSlowListener oSlow;
+		oSlow.m_onValue.Connect(oSender.SomethingChanged);
+		for (int i = 0; i < 64; ++i)
+			oSender.SomethingChanged.Notify(&oSender, 1, 0);
+		NCD_CHECK(oSlow.m_nCalls == 64 && oSlow.m_onValue.GetHistogram().GetCount() == 32);
+
+		std::string sReported;
+		CLatencyWatchdog oWatchdog(std::chrono::microseconds(200), [&sReported](SLatencyReport const& oReport)
+			{sReported += oReport.szListener;});
+		NCD_CHECK(oWatchdog.Check() == 1);
+		NCD_CHECK(sReported.find("CSlowListener::onValue") != std::string::npos);
+		NCD_CHECK(oWatchdog.Check() == 0);
+
+		// Every thread counts its own invocations, draining the window loses none of the concurrent samples
+		auto fnNop = [](int, int) {};
+		TProfiledConnection<int, int> oProbe;
+		oProbe.Init(fnNop, 4);
+		TNotification<int, int> oFirst, oSecond;
+		oProbe.Connect(oFirst);
+		oProbe.Connect(oSecond);
+		std::thread oOther([&oSecond]() {
+			for (int i = 0; i < 4000; ++i)
+				oSecond.Notify<void>(nullptr, 0, 0);
+		});
+		uint64_t nDrained = 0;
+		CLatencyHistogram::SSnapshot oWindow;
+		for (int i = 0; i < 4000; ++i)
+		{
+			oFirst.Notify<void>(nullptr, 0, 0);
+			if (i % 100 == 0)
+			{
+				oProbe.GetHistogram().Drain(oWindow);
+				nDrained += oWindow.nCount;
+			}
+		}
+		oOther.join();
+		NCD_CHECK(nDrained + oProbe.GetHistogram().GetCount() == 2000);
+	}
+
+	// Property emits only real changes, commit scopes emit once with the value before the outermost scope
+	{
+		CWindow oWindow;
+		std::vector<std::pair<int, int>> aChanges;
+		CWindow* pChanged = nullptr;
+		auto fnChanged = [&](CWindow* pWindow, int const& nOld, int const& nNew)
+		{
+			pChanged = pWindow;
+			aChanges.emplace_back(nOld, nNew);
+		};
+		using ChangeConnection = TConnection<int const&, int const&>;
+		ChangeConnection oCnctn(oWindow.Width.ntfChanged, ChangeConnection::DelegateType::CreateEx<CWindow>(fnChanged));
+
+		oWindow.Width = 800;
+		oWindow.Width = 800;
+		NCD_CHECK(aChanges.size() == 1 && aChanges[0] == std::make_pair(640, 800) && pChanged == &oWindow);
+		NCD_CHECK(!oWindow.Width.Set(800) && oWindow.Width.Set(801));
+
+		{
+			auto oOuter = oWindow.Width.Commit();
+			oWindow.Width = 1;
+			{
+				auto oInner = oWindow.Width.Commit();
+				oWindow.Width = 2;
+			}
+			NCD_CHECK(aChanges.size() == 2);
+			oWindow.Width = 3;
+		}
+		NCD_CHECK(aChanges.size() == 3 && aChanges[2] == std::make_pair(801, 3));
+
+		// Value returned to the original one within the commit is not a change
+		{
+			auto oCommit = oWindow.Width.Commit();
+			oWindow.Width = 5;
+			oWindow.Width = 3;
+		}
+		NCD_CHECK(aChanges.size() == 3 && oWindow.Width.Get() == 3);
+
+		// Value type need not be default constructible
+		int nExtentChanges = 0;
+		auto fnExtentChanged = [&nExtentChanges](SExtent const& oOld, SExtent const& oNew)
+		{
+			nExtentChanges += (oOld.m_nValue == 1 && oNew.m_nValue == 3) ? 1 : 100;
+		};
+		using ExtentConnection = TConnection<SExtent const&, SExtent const&>;
+		ExtentConnection oExtentCnctn(oWindow.Extent.ntfChanged, ExtentConnection::DelegateType::Create(fnExtentChanged));
+		{
+			auto oCommit = oWindow.Extent.Commit();
+			oWindow.Extent = SExtent(2);
+			oWindow.Extent = SExtent(3);
+		}
+		NCD_CHECK(nExtentChanges == 1 && oWindow.Extent.Get().m_nValue == 3);
+	}
+
+	// Chaining connection is allocated only when the notification is chained, queries do not allocate it
+	{
+		CSender1 oUpstream, oDownstream;
+		Counter oCounter;
+		TConnection<int, int> oCnctn(oDownstream.SomethingChanged, TConnection<int, int>::DelegateType::Create(oCounter));
+		TChainConnection<int, int> const& oChain = oDownstream.SomethingChanged.cnt_Notify;
+		NCD_CHECK(!oChain.IsAllocated());
+		NCD_CHECK(!oChain.IsConnected(oUpstream.SomethingChanged) && !oChain.IsMuted());
+		NCD_CHECK(!oDownstream.SomethingChanged.cnt_Notify.Disconnect(oUpstream.SomethingChanged));
+		NCD_CHECK(!oChain.IsAllocated());
+
+		oDownstream.SomethingChanged.cnt_Notify.Connect(oUpstream.SomethingChanged);
+		NCD_CHECK(oChain.IsAllocated() && oChain.IsConnected(oUpstream.SomethingChanged));
+		oUpstream.DoSomething();
+		{
+			auto oMute = oDownstream.SomethingChanged.cnt_Notify.Mute();
+			oUpstream.DoSomething();
+		}
+		oUpstream.DoSomething();
+		NCD_CHECK(oCounter.m_nCalls == 2);
+
+		// Relocated notification keeps its allocated chaining connection and emits itself
+		std::vector<Notification<CSender1, int, int>> aChained(1);
+		oCnctn.Connect(aChained[0]);
+		aChained[0].cnt_Notify.Connect(oUpstream.SomethingChanged);
+		aChained.resize(aChained.capacity() + 1);
+		oUpstream.DoSomething();
+		NCD_CHECK(oCounter.m_nCalls == 4);
+
+		// Chaining connection keeps the TConnection interface, Invoke does not allocate it
+		CSender1 oLinked;
+		oLinked.SomethingChanged.cnt_Notify.Invoke(&oLinked, 0, 1);
+		NCD_CHECK(!oLinked.SomethingChanged.cnt_Notify.IsAllocated() && oCounter.m_nCalls == 4);
+		oCnctn.Connect(oLinked.SomethingChanged);
+		oLinked.SomethingChanged.cnt_Notify.Invoke(&oLinked, 0, 1);
+		NCD_CHECK(!oLinked.SomethingChanged.cnt_Notify.IsAllocated() && oCounter.m_nCalls == 5);
+		TConnection<int, int>& oLinkedCnctn = oLinked.SomethingChanged.cnt_Notify;
+		NCD_CHECK(oLinked.SomethingChanged.cnt_Notify.IsAllocated() && !oLinkedCnctn.HasConnectedNotifications());
+		oLinked.SomethingChanged.cnt_Notify.Init(oUpstream.SomethingChanged, oLinked.SomethingChanged.cnt_Notify.GetDelegate());
+		oUpstream.DoSomething();
+		NCD_CHECK(oLinkedCnctn.IsConnected(oUpstream.SomethingChanged) && oCounter.m_nCalls == 8);
+	}
+
+	// Handles of destroyed connections become stale, deferred deliveries through them do nothing
+	{
+		CHandleMap oMap;
+		CSender1 oSender;
+		Counter oCounter;
+		TConnectionHandle<int, int> hStale;
+		NCD_CHECK(hStale.IsNull() && !oMap.Invoke(hStale, &oSender, 0, 1));
+		{
+			HandleConnection<int, int> oCnctn(HandleConnection<int, int>::DelegateType::Create(oCounter), oMap);
+			hStale = oCnctn.GetHandle();
+			NCD_CHECK(oMap.IsAlive(hStale) && oMap.GetSize() == 1);
+			NCD_CHECK(oMap.Invoke(hStale, &oSender, 0, 1) && oCounter.m_nCalls == 1);
+		}
+		NCD_CHECK(!oMap.IsAlive(hStale) && !oMap.Invoke(hStale, &oSender, 0, 1) && oMap.GetSize() == 0);
+
+		// Reused slot gets the new generation, relocated connection keeps its handle
+		std::vector<HandleConnection<int, int>> aCnctns;
+		aCnctns.reserve(1);
+		aCnctns.emplace_back(HandleConnection<int, int>::DelegateType::Create(oCounter), oMap);
+		TConnectionHandle<int, int> hFirst = aCnctns[0].GetHandle();
+		NCD_CHECK(hFirst.nIndex == hStale.nIndex && hFirst != hStale);
+		aCnctns.emplace_back(HandleConnection<int, int>::DelegateType::Create(oCounter), oMap);
+		NCD_CHECK(oMap.Resolve(hFirst) == &aCnctns[0]);
+		NCD_CHECK(oMap.Invoke(hFirst, &oSender, 0, 1) && oCounter.m_nCalls == 2);
+		aCnctns.erase(aCnctns.begin());
+		NCD_CHECK(!oMap.IsAlive(hFirst) && oMap.GetSize() == 1);
+	}
+
+	// Handle connection constructed with its owner follows the relocated owner
+	{
+		CSender1 oSender;
+		std::vector<CHandleListener> aListeners;
+		aListeners.reserve(1);
+		aListeners.emplace_back(1);
+		aListeners.back().m_onSomethingChanged.Connect(oSender.SomethingChanged);
+		TConnectionHandle<int, int> hListener = aListeners.back().m_onSomethingChanged.GetHandle();
+		aListeners.emplace_back(2);
+		oSender.DoSomething();
+		NCD_CHECK(aListeners[0].m_nSum == 2 && aListeners[1].m_nSum == 0);
+		NCD_CHECK(CHandleMap::ThreadDefault().Invoke(hListener, &oSender, 0, 1) && aListeners[0].m_nSum == 4);
+	}
+
+	// Waiter wakes up on any of its notifications, keeps the latest pending emission per source
+	{
+		CSender1 oSender;
+		Waiter oWaiter;
+		auto& oSomething = oWaiter.Attach(oSender.SomethingChanged);
+		auto& oNothing = oWaiter.Attach(oSender.NothingChanged);
+		NCD_CHECK(oWaiter.Wait(std::chrono::milliseconds(1)) == nullptr);
+
+		oSender.SomethingChanged.Notify(&oSender, 1, 2);
+		oSender.SomethingChanged.Notify(&oSender, 3, 4);
+		NCD_CHECK(oWaiter.Wait() == &oSomething && oSomething.GetOverwritten() == 1);
+		NCD_CHECK(oSomething.Take() == std::make_tuple(3, 4) && !oSomething.IsPending());
+
+		// Emission from another thread wakes the sleeping waiter
+		std::thread oEmitter([&oSender]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			oSender.DoNothing();
+		});
+		NCD_CHECK(oWaiter.Wait(std::chrono::seconds(10)) == &oNothing);
+		oEmitter.join();
+		oNothing.Take();
+
+		// Both pending sources are reported, one by one
+		oSender.DoSomething();
+		oSender.DoNothing();
+		CWaitSourceBase* pFirst = oWaiter.Poll();
+		NCD_CHECK(pFirst != nullptr);
+		if (pFirst == &oSomething)
+			oSomething.Take();
+		else
+			oNothing.Take();
+		CWaitSourceBase* pSecond = oWaiter.Poll();
+		NCD_CHECK(pSecond != nullptr && pSecond != pFirst);
+	}
+
+	// Published payload is shared by the listeners without copying the value, pool recycles released blocks
+	{
+		using Frame = Payload<std::vector<int>>;
+		using FrameConnection = TConnection<Frame const&>;
+		Notification<CSender1, Frame const&> oFrameReady;
+		PayloadPool<std::vector<int>> oPool(2);
+		size_t nSeen = 0;
+		std::vector<Frame> aKept;
+		auto fnSee = [&nSeen](Frame const& oFrame) {nSeen += oFrame->size();};
+		auto fnKeep = [&aKept](Frame const& oFrame) {aKept.push_back(oFrame);};
+		FrameConnection oSee(oFrameReady, FrameConnection::DelegateType::Create(fnSee));
+		FrameConnection oKeep1(oFrameReady, FrameConnection::DelegateType::Create(fnKeep));
+		FrameConnection oKeep2(oFrameReady, FrameConnection::DelegateType::Create(fnKeep));
+
+		{
+			auto oBuilder = oPool.Allocate();
+			oBuilder->assign(1000, 7);
+			oFrameReady.Notify(nullptr, oBuilder.Publish());
+			NCD_CHECK(oBuilder.IsNull());
+		}
+		NCD_CHECK(nSeen == 1000 && aKept.size() == 2);
+		NCD_CHECK(aKept[0].GetRefCount() == 2 && &*aKept[0] == &*aKept[1]);
+		NCD_CHECK(oPool.GetUsed() == 1);
+		aKept.clear();
+		NCD_CHECK(oPool.GetUsed() == 0 && oPool.GetCapacity() == 2);
+
+		// Pool grows when exhausted, unpublished builder returns its block
+		{
+			Frame oFirst = oPool.Make(), oSecond = oPool.Make(), oThird = oPool.Make();
+			NCD_CHECK(oPool.GetCapacity() == 4 && oPool.GetUsed() == 3);
+		}
+		{
+			auto oBuilder = oPool.Allocate();
+		}
+		NCD_CHECK(oPool.GetUsed() == 0);
+
+		// Shared payload is copied and released on several threads
+		SharedPayloadPool<std::string> oSharedPool(4);
+		SharedPayload<std::string> oText = oSharedPool.Make("hello");
+		std::vector<std::thread> aThreads;
+		for (int i = 0; i < 4; ++i)
+		{
+			aThreads.emplace_back([oText]() {
+				for (int j = 0; j < 10000; ++j)
+					SharedPayload<std::string> oCopy = oText;
+			});
+		}
+		for (std::thread& oThread : aThreads)
+			oThread.join();
+		NCD_CHECK(oText.GetRefCount() == 1 && *oText == "hello");
+		oText.Reset();
+		NCD_CHECK(oSharedPool.GetUsed() == 0);
+	}
+
+	// Class-wide notification reaches all its connections, filtered ones only for their sender
+	{
+		CSession oFirst(1), oSecond(2), oThird(3);
+		int nAll = 0, nSecond = 0, nThird = 0;
+		auto fnAll = [&nAll](int nId) {nAll += nId;};
+		auto fnSecond = [&nSecond](int nId) {nSecond += nId;};
+		auto fnThird = [&nThird](int nId) {nThird += nId;};
+		using SessionConnection = TConnection<int>;
+		SessionConnection oAll(SessionConnection::DelegateType::Create(fnAll));
+		SessionConnection oOfSecond(SessionConnection::DelegateType::Create(fnSecond));
+		SessionConnection oOfThird(SessionConnection::DelegateType::Create(fnThird));
+		CSession::Closed.Connect(oAll);
+		CSession::Closed.Connect(oOfSecond, &oSecond);
+		CSession::Closed.Connect(oOfThird, &oThird);
+		NCD_CHECK(CSession::Closed.GetFilteredSenderCount() == 2);
+
+		oFirst.Close();
+		NCD_CHECK(nAll == 1 && nSecond == 0 && nThird == 0);
+		oSecond.Close();
+		NCD_CHECK(nAll == 3 && nSecond == 2 && nThird == 0);
+		NCD_CHECK(CSession::Closed.GetFilteredSenderCount() == 1 && !oOfSecond.HasConnectedNotifications());
+
+		// Filter left without connections is dropped by Shrink
+		{
+			SessionConnection oTemporary(SessionConnection::DelegateType::Create(fnThird));
+			CSession::Closed.Connect(oTemporary, &oFirst);
+		}
+		NCD_CHECK(CSession::Closed.GetFilteredSenderCount() == 2);
+		CSession::Closed.Shrink();
+		NCD_CHECK(CSession::Closed.GetFilteredSenderCount() == 1);
+
+		oThird.Close();
+		NCD_CHECK(nAll == 6 && nThird == 3 && CSession::Closed.GetFilteredSenderCount() == 0);
+		NCD_CHECK(CSession::Closed.Disconnect(oAll));
+		oThird.Close();
+		NCD_CHECK(nAll == 6);
+	}
+
+	// Exception thrown by the listener leaves Notify (default policy), emission state is restored
+	{
+		CSender1 oSender;
+		static_assert(!noexcept(oSender.SomethingChanged.Notify(&oSender, 0, 1)), "Propagating emission should not be noexcept");
+		bool bThrow = true;
+		auto fnThrow = [&bThrow](int, int)
+		{
+			if (bThrow)
+				throw std::runtime_error("listener failed");
+		};
+		Counter oCounter;
+		TConnection<int, int> oThrowing(oSender.SomethingChanged, TConnection<int, int>::DelegateType::Create(fnThrow));
+		TConnection<int, int> oCounting(oSender.SomethingChanged, TConnection<int, int>::DelegateType::Create(oCounter));
+
+		bool bCaught = false;
+		try
+		{
+			oSender.DoSomething();
+		}
+		catch (std::runtime_error const&)
+		{
+			bCaught = true;
+		}
+		NCD_CHECK(bCaught && oCounter.m_nCalls == 0);
+
+		// Following emissions and removals work as usual
+		bThrow = false;
+		oSender.DoSomething();
+		NCD_CHECK(oCounter.m_nCalls == 1);
+		oThrowing.DisconnectAll();
+		oSender.DoSomething();
+		NCD_CHECK(oCounter.m_nCalls == 2 && oSender.SomethingChanged.HasConnections());
+	}
+
+	// Connection lists report the lower bound of their heap memory, compaction shrinks them with hysteresis
+	// once most of the links are removed
+	{
+		Notification<CSender1, int, int> oNtfctn;
+		CNotificationBase const& oList = oNtfctn;
+		NCD_CHECK(oList.MemoryUsage() == 0);
+		Counter oCounter;
+		std::vector<std::unique_ptr<TConnection<int, int>>> aCnctns;
+		for (int i = 0; i < 1000; ++i)
+		{
+			aCnctns.emplace_back(new TConnection<int, int>(TConnection<int, int>::DelegateType::Create(oCounter)));
+			oNtfctn.AddConnection(*aCnctns.back());
+		}
+		size_t const nFull = oList.MemoryUsage();
+		NCD_CHECK(nFull >= 1000 * sizeof(void*));
+
+		for (int i = 0; i < 990; ++i)
+			oNtfctn.RemoveConnection(*aCnctns[i]);
+		size_t const nShrunk = oList.MemoryUsage();
+		NCD_CHECK(nShrunk < nFull / 4 && nShrunk >= 10 * sizeof(void*));
+		oNtfctn.RemoveConnection(*aCnctns[990]);
+		NCD_CHECK(oList.MemoryUsage() == nShrunk);
+		oNtfctn.ShrinkToFit();
+		NCD_CHECK(oList.MemoryUsage() < nShrunk && oList.MemoryUsage() >= 9 * sizeof(void*));
+
+		// Notification set of the connection keeps its buckets upon removals, ShrinkToFit releases them
+		std::vector<TNotification<int, int>> aNtfctns(500);
+		TConnection<int, int> oCnctn(TConnection<int, int>::DelegateType::Create(oCounter));
+		size_t nLinked = oCnctn.MemoryUsage();
+		for (TNotification<int, int>& oItem : aNtfctns)
+		{
+			oItem.AddConnection(oCnctn);
+			NCD_CHECK(oCnctn.MemoryUsage() > nLinked);
+			nLinked = oCnctn.MemoryUsage();
+		}
+		for (size_t i = 0; i < 495; ++i)
+			aNtfctns[i].RemoveConnection(oCnctn);
+		size_t const nUnlinked = oCnctn.MemoryUsage();
+		NCD_CHECK(nUnlinked < nLinked);
+		oCnctn.ShrinkToFit();
+		NCD_CHECK(oCnctn.MemoryUsage() < nUnlinked / 4);
+
+		// Removal during the emission is compacted (and released) when the emission ends
+		CSender1 oSender;
+		auto fnClear = [&oSender](int, int) {oSender.SomethingChanged.RemoveAllConnections();};
+		TConnection<int, int> oClear(oSender.SomethingChanged, TConnection<int, int>::DelegateType::Create(fnClear));
+		for (size_t i = 0; i < 200; ++i)
+			aCnctns[i]->Connect(oSender.SomethingChanged);
+		oSender.DoSomething();
+		NCD_CHECK(!oSender.SomethingChanged.HasConnections());
+		NCD_CHECK(static_cast<CNotificationBase const&>(oSender.SomethingChanged).MemoryUsage() == 0);
+	}
+
+	// Lazy emission computes the arguments only when some listener would be invoked
+	{
+		CSender1 oSender;
+		int nProduced = 0;
+		auto fnProduce = [&nProduced]()
+		{
+			++nProduced;
+			return std::make_tuple(2, 3);
+		};
+		NCD_CHECK(!oSender.SomethingChanged.HasActiveListeners());
+		NCD_CHECK(!oSender.SomethingChanged.NotifyLazy(&oSender, fnProduce) && nProduced == 0);
+
+		Counter oFirst, oSecond;
+		TConnection<int, int> oFirstCnctn(oSender.SomethingChanged, TConnection<int, int>::DelegateType::Create(oFirst));
+		TConnection<int, int> oSecondCnctn(oSender.SomethingChanged, TConnection<int, int>::DelegateType::Create(oSecond));
+		NCD_CHECK(oSender.SomethingChanged.HasActiveListeners());
+
+		// Muted and blocked listeners are not interested
+		oFirstCnctn.SetMuteState(true);
+		{
+			auto oMute = oSecondCnctn.Mute();
+			NCD_CHECK(!oSender.SomethingChanged.HasActiveListeners());
+			NCD_CHECK(!oSender.SomethingChanged.NotifyLazy(&oSender, fnProduce) && nProduced == 0);
+		}
+		NCD_CHECK(oSender.SomethingChanged.NotifyLazy(&oSender, fnProduce) && nProduced == 1);
+		NCD_CHECK(oFirst.m_nCalls == 0 && oSecond.m_nCalls == 1);
+		{
+			auto oBlock = oSender.SomethingChanged.Block();
+			NCD_CHECK(!oSender.SomethingChanged.NotifyLazy(&oSender, fnProduce) && nProduced == 1);
+		}
+
+		// Connection added muted counts once unmuted
+		oSecondCnctn.DisconnectAll();
+		NCD_CHECK(!oSender.SomethingChanged.HasActiveListeners());
+		oFirstCnctn.SetMuteState(false);
+		NCD_CHECK(oSender.SomethingChanged.HasActiveListeners());
+		oFirstCnctn.DisconnectAll();
+		oFirstCnctn.SetMuteState(true);
+		oFirstCnctn.Connect(oSender.SomethingChanged);
+		NCD_CHECK(!oSender.SomethingChanged.HasActiveListeners());
+		oFirstCnctn.SetMuteState(false);
+		NCD_CHECK(oSender.SomethingChanged.HasActiveListeners());
+	}
+
+	// Static connection is constant initialized and constructed upon the first use
+	{
+		NCD_CHECK(!CStaticListener::cnt_onSomethingChanged.IsConstructed());
+		CStaticListener::cnt_onSomethingChanged.Connect(pSender2->SomethingChanged);
+		NCD_CHECK(CStaticListener::cnt_onSomethingChanged.IsConstructed());
+		pSender2->DoSomething();
+		NCD_CHECK(CStaticListener::s_nCalls == 1);
+		NCD_CHECK(CStaticListener::cnt_onSomethingChanged.Disconnect(pSender2->SomethingChanged));
+		pSender2->DoSomething();
+		NCD_CHECK(CStaticListener::s_nCalls == 1);
+
+		CSender1 oSender;
+		CStaticListener::Listen(oSender.SomethingChanged);
+		oSender.DoSomething();
+		NCD_CHECK(CStaticListener::s_nCalls == 2);
+
+		// Concurrent first uses construct the connection once
+		static_assert(std::is_trivially_destructible<decltype(CRacingStaticListener::cnt_onSomethingChanged)>::value,
+					  "Static connection should be trivially destructible");
+		void const* aConstructed[4] = {};
+		std::vector<std::thread> aThreads;
+		for (void const*& pConstructed : aConstructed)
+			aThreads.emplace_back([&pConstructed]() {pConstructed = &CRacingStaticListener::cnt_onSomethingChanged.Get();});
+		for (std::thread& oThread : aThreads)
+			oThread.join();
+		NCD_CHECK(CRacingStaticListener::cnt_onSomethingChanged.IsConstructed());
+		NCD_CHECK(aConstructed[0] == aConstructed[1] && aConstructed[0] == aConstructed[2] && aConstructed[0] == aConstructed[3]);
+	}
+
 	pSender2->NothingChanged.RemoveAllConnections();
 	pSender2->SomethingChanged.RemoveConnection(oFuncCnctn);
 
@@ -388,5 +1622,5 @@ int main()
 
 	delete pSender2;
 
-	return 0;
+	return (g_nFailedChecks == 0) ? 0 : 1;
 }